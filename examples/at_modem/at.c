@@ -30,30 +30,35 @@ static void *UartHandle = NULL;
 static unsigned State = AT_STATE_INIT;
 
 static int ASCIIToHex(char *Dest, const char *Src) {
-  int char_cnt = 0;
-  if (strlen(Src) == 0) return -1;
-  for (int i = 0; i < strlen(Src); i++) {
+  const size_t len = strlen(Src);
+  if (len == 0) return -1;
+  if (len % 2 != 0) {
+    DEBUG_ERROR("Number of characters is not even\n");
+    return -1;
+  }
+  for (size_t i = 0; i < len; i++) {
     char ch = Src[i];
     if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'F')) {
-      if (char_cnt % 2 == 0) {  // Even position
-        Dest[char_cnt / 2] = (ch <= '9' ? ch - '0' : ch - 'A' + 0xa) << 4;
+      if (i % 2 == 0) {  // Even position
+        Dest[i / 2] = (ch <= '9' ? ch - '0' : ch - 'A' + 0xa) << 4;
       } else {  // Odd position
-        Dest[char_cnt / 2] += (ch <= '9' ? ch - '0' : ch - 'A' + 0xa);
+        Dest[i / 2] += (ch <= '9' ? ch - '0' : ch - 'A' + 0xa);
       }
-      char_cnt++;
     } else {
       DEBUG_ERROR("Hex string contains illegal characters 0x%02x\n", ch);
       return -1;
     }
   }
-  if (char_cnt % 2 != 0) {
-    DEBUG_ERROR("Number of characters is not even\n");
-    return -1;
-  }
-  return (char_cnt / 2);
+  return (len / 2);
 }
 
+static int ATTablesInit(void);
+
 int ATInit() {
+  if (ATTablesInit() != 0) {
+    DEBUG_ERROR("Handler tables out of order\n");
+    return -1;
+  }
   UartHandle = UARTInit(UART_INTERFACE, UART_BAUDRATE, 0);
   if (UartHandle == NULL) {
     DEBUG_ERROR("Failed to initialise uart\n");
@@ -64,6 +69,7 @@ int ATInit() {
 
 size_t ATReceive(char *Rx, size_t MaxLength) {
   const uint32_t start = TickGet();
+  uint32_t last_rx = start;
   size_t count = 0;
   while ((TickGet() - start < RECEIVE_TIMEOUT) && (count <= MaxLength)) {
     uint8_t ch;
@@ -71,6 +77,10 @@ size_t ATReceive(char *Rx, size_t MaxLength) {
       if (count < MaxLength) {
         Rx[count++] = ch;
       }
+      last_rx = TickGet();
+    } else if (count > 0 && TickGet() - last_rx >= RECEIVE_IDLE) {
+      // frame ended on line idle, no need to wait out the full timeout
+      break;
     }
   }
   return count;
@@ -94,7 +104,43 @@ static int ATRespond(const char *Header, const char *Command,
   return 0;
 }
 
-void ATSend(char *Tx) { UARTWrite(UartHandle, (uint8_t *)Tx, strlen(Tx)); }
+// While a received batch of commands is being processed, responses queue up
+// and go out in one UARTWrite at the end instead of one blocking write per
+// line. Outside of ATProcess, ATSend writes directly as before.
+static uint8_t TxQueue[AT_TX_QUEUE_SIZE];
+static size_t TxFill = 0;
+static bool TxBatch = false;
+
+void ATFlush(void) {
+  if (TxFill > 0) UARTWrite(UartHandle, TxQueue, TxFill);
+  TxFill = 0;
+}
+
+void ATSend(char *Tx) {
+  const size_t len = strlen(Tx);
+  if (!TxBatch || len > sizeof(TxQueue)) {
+    ATFlush();
+    UARTWrite(UartHandle, (uint8_t *)Tx, len);
+    return;
+  }
+  if (TxFill + len > sizeof(TxQueue)) ATFlush();
+  memcpy(TxQueue + TxFill, Tx, len);
+  TxFill += len;
+}
+
+#ifdef AT_HIGH_BAUD
+// Software flow control: hold the host off while a batch is being processed
+// so commands are not lost at high baud
+#define AT_XOFF 0x13
+#define AT_XON 0x11
+static void ATFlowControl(uint8_t Code) {
+  UARTWrite(UartHandle, &Code, 1);
+}
+#else
+#define AT_XOFF 0
+#define AT_XON 0
+static void ATFlowControl(uint8_t Code) {}
+#endif
 
 void ATSetState(SysStates State) {
   switch (State) {
@@ -389,47 +435,72 @@ static const ControlHandler_t ControlHandlers[] = {
     {AT_CONTROL_SUSPEND_MODE, &ControlSuspendMode},
 };
 
-static void *GetHandlder(const char *CmdStr, const char *Strs[],
-                         const CmdHandler_t *Handlers, unsigned CmdNum,
-                         unsigned *CmdId) {
+// Command indices ordered by command string, built once at init, so a
+// command dispatches by binary search instead of scanning the tables for
+// every received command. The handler tables are in enum order, checked at
+// init, so the matched index selects the handler directly.
+static uint8_t QueryOrder[AT_QUERY_NUM];
+static uint8_t ControlOrder[AT_CONTROL_NUM];
+
+static void SortCommands(const char *Strs[], uint8_t *Order, unsigned Num) {
+  for (unsigned int i = 0; i < Num; i++) Order[i] = i;
+  // insertion sort, the tables are small and this runs once
+  for (unsigned int i = 1; i < Num; i++) {
+    const uint8_t key = Order[i];
+    int j = i - 1;
+    while (j >= 0 && strcmp(Strs[Order[j]], Strs[key]) > 0) {
+      Order[j + 1] = Order[j];
+      j--;
+    }
+    Order[j + 1] = key;
+  }
+}
+
+static int FindCommand(const char *CmdStr, const char *Strs[],
+                       const uint8_t *Order, unsigned Num) {
+  int lo = 0;
+  int hi = Num - 1;
+  while (lo <= hi) {
+    const int mid = (lo + hi) / 2;
+    const int cmp = strcmp(CmdStr, Strs[Order[mid]]);
+    if (cmp == 0) return Order[mid];
+    if (cmp < 0)
+      hi = mid - 1;
+    else
+      lo = mid + 1;
+  }
+  return -1;
+}
+
+static int ATTablesInit(void) {
   BUILD_BUG_ON(AT_QUERY_NUM != NUM_ELEMS(Queries));
   BUILD_BUG_ON(AT_CONTROL_NUM != NUM_ELEMS(Controls));
   BUILD_BUG_ON(AT_ERROR_NUM != NUM_ELEMS(ErrorCodes));
   BUILD_BUG_ON(AT_QUERY_NUM != NUM_ELEMS(QueryHandlers));
   BUILD_BUG_ON(AT_CONTROL_NUM != NUM_ELEMS(ControlHandlers));
 
-  void *Handler = NULL;
-  for (unsigned int i = 0; i < CmdNum; i++) {
-    if ((strlen(CmdStr) == strlen(Strs[i])) &&
-        (memcmp(CmdStr, Strs[i], strlen(CmdStr)) == 0)) {
-      for (unsigned int j = 0; j < CmdNum; j++) {
-        if (Handlers[j].Id == i) {
-          Handler = Handlers[j].Handler;
-          *CmdId = i;
-          break;
-        }
-      }
-      if (Handler != NULL) break;
-    }
-  }
-  return Handler;
+  // direct indexing below requires the handler tables in enum order
+  for (unsigned int i = 0; i < AT_QUERY_NUM; i++)
+    if (QueryHandlers[i].Id != i) return -1;
+  for (unsigned int i = 0; i < AT_CONTROL_NUM; i++)
+    if (ControlHandlers[i].Id != i) return -1;
+  SortCommands(Queries, QueryOrder, AT_QUERY_NUM);
+  SortCommands(Controls, ControlOrder, AT_CONTROL_NUM);
+  return 0;
 }
 
 static bool ProcessQuery(char *CmdStr) {
-  unsigned CmdId;
-  void *Handler = GetHandlder(CmdStr, Queries, (CmdHandler_t *)QueryHandlers,
-                              AT_QUERY_NUM, &CmdId);
-  if (Handler == NULL) return false;
-  ((QueryHandlerFunc_t)Handler)(CmdId);
+  const int CmdId = FindCommand(CmdStr, Queries, QueryOrder, AT_QUERY_NUM);
+  if (CmdId < 0) return false;
+  QueryHandlers[CmdId].Handler(CmdId);
   return true;
 }
 
 static bool ProcessControl(char *CmdStr, const char *Para) {
-  unsigned CmdId;
-  void *Handler = GetHandlder(CmdStr, Controls, (CmdHandler_t *)ControlHandlers,
-                              AT_CONTROL_NUM, &CmdId);
-  if (Handler == NULL) return false;
-  ((ControlHandlerFunc_t)Handler)(CmdId, Para);
+  const int CmdId =
+      FindCommand(CmdStr, Controls, ControlOrder, AT_CONTROL_NUM);
+  if (CmdId < 0) return false;
+  ControlHandlers[CmdId].Handler(CmdId, Para);
   return true;
 }
 
@@ -453,6 +524,8 @@ static int ATCmdProcess(char *Cmd, const char *Para) {
 
 void ATProcess(char *Input, int Len) {
   bool invalid_cmd;
+  ATFlowControl(AT_XOFF);
+  TxBatch = true;
   char *input_start = Input;
   char *cmd_start = Input, *cmd_end = Input;
   const char *input_end = Input + Len - 1;
@@ -489,20 +562,22 @@ void ATProcess(char *Input, int Len) {
           input_start = cmd_end + 1;
           continue;
         }
+        // Tokenize in place: the command and parameter stay in the RX
+        // buffer, already terminated at cmd_end, instead of being copied
         char *cmd = cmd_start + strlen(AT_CMD_START);
-        char para[AT_MAX_PARA_LEN + 1] = {0};
-        if (strstr(cmd, "=") != NULL) {
-          strtok(cmd, "=");
+        const char *para = "";
+        char *eq = strchr(cmd, '=');
+        if (eq != NULL) {
+          *eq = '\0';
           if (strlen(cmd) > AT_MAX_CMD_LEN) {
             invalid_cmd = true;
             DEBUG_ERROR("Command too long\n");
           }
-          char *p = strtok(NULL, "=");
-          if (strlen(p) > AT_MAX_PARA_LEN) {
+          if (strlen(eq + 1) > AT_MAX_PARA_LEN) {
             invalid_cmd = true;
             DEBUG_ERROR("Parameter too long\n");
           } else {
-            strcpy(para, p);
+            para = eq + 1;
           }
         }
         if (invalid_cmd == false) {
@@ -519,4 +594,7 @@ void ATProcess(char *Input, int Len) {
     if (cmd_end == input_end) break;
     input_start = cmd_end + 1;
   }
+  TxBatch = false;
+  ATFlush();
+  ATFlowControl(AT_XON);
 }
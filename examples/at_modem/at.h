@@ -34,11 +34,29 @@
 
 #define TICK_PER_SECOND 1000
 
+// The default transport is the low energy UART at 9600 baud, woken by
+// leuart activity. Build with -DAT_HIGH_BAUD to run on UART_0 at 115200
+// baud (override with AT_UART_BAUDRATE) with XON/XOFF software flow
+// control; the host then wakes the modem by driving GPIO0_WKUP high before
+// sending.
+#ifdef AT_HIGH_BAUD
+#define UART_INTERFACE UART_0
+#ifndef AT_UART_BAUDRATE
+#define AT_UART_BAUDRATE 115200
+#endif
+#define UART_BAUDRATE AT_UART_BAUDRATE
+#define MODEM_WAKE_EVENT OnGPIOWakeup
+#define MODEM_WAKE_PIN PIN_GPIO0_WKUP
+#else
 #define UART_INTERFACE LEUART
 #define UART_BAUDRATE 9600
+#define MODEM_WAKE_EVENT OnLeuartReceive
+#endif
 #define UART_MAX_TX_SIZE 60
 #define UART_MAX_RX_SIZE 80
 #define RECEIVE_TIMEOUT 200  // [ms]
+#define RECEIVE_IDLE 10      // [ms] line idle gap ending a receive
+#define AT_TX_QUEUE_SIZE 256
 
 #define RF_TX_TIMEOUT_MAX 999000  // [ms]
 #define VHF_TX_DEFAULT_FREQUENCY 161450000
@@ -78,6 +96,8 @@ size_t ATReceive(char *Rx, size_t MaxLength);
 
 void ATSend(char *Tx);
 
+void ATFlush(void);
+
 void ATProcess(char *Start, int Len);
 
 time_t KeepRFAwake();
@@ -28,7 +28,7 @@ static time_t ModemReceive() {
   } else {
     printf("No data received\n");
   }
-  return OnLeuartReceive();
+  return MODEM_WAKE_EVENT();
 }
 
 static time_t UARTReady() {
@@ -47,12 +47,17 @@ static time_t UARTReady() {
 
 void AppInit() {
   ScheduleJob(UARTReady, ASAP());
-  ScheduleJob(ModemReceive, OnLeuartReceive());
+  ScheduleJob(ModemReceive, MODEM_WAKE_EVENT());
 }
 
 int BoardStart(void) {
   GPIOSetModeOutput(MODEM_BUSY);
   GPIOSetHigh(MODEM_BUSY);
+#ifdef AT_HIGH_BAUD
+  // the host wakes the modem for a command by driving the wake pin high
+  GPIOSetModeInput(MODEM_WAKE_PIN, GPIO_PULL_DOWN);
+  GPIOSetWakeupLevel(MODEM_WAKE_PIN, GPIO_HIGH);
+#endif
   if (ATInit())
     printf("Failed to init modem\n");
   else {
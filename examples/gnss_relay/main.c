@@ -19,30 +19,44 @@
 
 #include "myriota_user_api.h"
 
-#define GNSS_DEFAULT_BAUDRATE 9600
+// Override with CFLAGS=-DGNSS_BAUDRATE=115200 to run the receiver at its
+// native rate, the block relay below keeps up where a byte at a time loop
+// saturates the CPU and drops sentences.
+#ifndef GNSS_BAUDRATE
+#define GNSS_BAUDRATE 9600
+#endif
+// covers the UART driver's 50 byte input buffer in one read
+#define RELAY_BLOCK_SIZE 64
 
 void AppInit() {}
 
+// Forward whatever has accumulated on one port to the other in blocks. A
+// short read means the line has gone idle, so each burst of reads forwards
+// one frame, e.g. an NMEA sentence, in a couple of writes.
+static void Relay(void *FromHandle, void *ToHandle) {
+  uint8_t buf[RELAY_BLOCK_SIZE];
+  int n;
+  while ((n = UARTRead(FromHandle, buf, sizeof(buf))) > 0) {
+    UARTWrite(ToHandle, buf, n);
+    if ((size_t)n < sizeof(buf)) break;
+  }
+}
+
 int BoardStart() {
   void *uart0_handle, *uart1_handle;
 
   // Repurpose the debug port
   BoardDebugDeinit();
-  uart0_handle = UARTInit(UART_0, GNSS_DEFAULT_BAUDRATE, 0);
+  uart0_handle = UARTInit(UART_0, GNSS_BAUDRATE, 0);
 
   // Configure the GNSS UART port
-  uart1_handle = UARTInit(UART_1, GNSS_DEFAULT_BAUDRATE, 0);
+  uart1_handle = UARTInit(UART_1, GNSS_BAUDRATE, 0);
   BoardGNSSPowerEnable();
 
   // Replay GNSS traffic
   while (1) {
-    uint8_t Ch;
-    while (1 == UARTRead(uart1_handle, &Ch, 1)) {
-      UARTWrite(uart0_handle, &Ch, 1);
-    }
-    while (1 == UARTRead(uart0_handle, &Ch, 1)) {
-      UARTWrite(uart1_handle, &Ch, 1);
-    }
+    Relay(uart1_handle, uart0_handle);
+    Relay(uart0_handle, uart1_handle);
   }
   return 0;
 }
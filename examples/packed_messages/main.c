@@ -0,0 +1,61 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A metering application sending small readings. Readings are coalesced into
+// shared transmit frames by the packing layer in message_pack.h rather than
+// each consuming a full MAX_MESSAGE_SIZE of queue space, so more readings
+// are delivered per day at the same radio duty cycle. Frames are flushed
+// immediately before a satellite transmit opportunity.
+
+#include "message_pack.h"
+#include "myriota_user_api.h"
+
+// Format of an individual reading. Values are little endian
+typedef struct {
+  uint16_t sequence_number;
+  int16_t temperature;       // degrees Celsius scaled by 100
+  uint16_t battery_voltage;  // millivolt
+} __attribute__((packed)) meter_reading;
+
+static time_t Meter(void) {
+  static unsigned int sequence_number = 0;
+
+  float temperature = 0;
+  if (TemperatureGet(&temperature)) printf("Failed to read temperature\n");
+  uint32_t mv = 0;
+  if (BatteryGetVoltage(&mv)) printf("Failed to read battery voltage\n");
+
+  const meter_reading reading = {sequence_number, temperature * 100, mv};
+  if (PackedMessageSchedule(&reading, sizeof(reading)) != 0)
+    printf("Failed to schedule reading\n");
+  else
+    printf("Packed reading: %u %.2f %u\n", sequence_number, temperature,
+           (unsigned int)mv);
+
+  sequence_number++;
+
+  return HoursFromNow(4);
+}
+
+static time_t Flush(void) {
+  if (PackedMessageFlush() != 0) printf("Failed to schedule frame\n");
+
+  // Flush shortly before the next transmit opportunity so partially filled
+  // frames still go out at least once a day
+  return BeforeSatelliteTransmit(HoursFromNow(8), HoursFromNow(24));
+}
+
+void AppInit() {
+  ScheduleJob(Meter, ASAP());
+  ScheduleJob(Flush, BeforeSatelliteTransmit(HoursFromNow(8), HoursFromNow(24)));
+}
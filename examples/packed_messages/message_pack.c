@@ -0,0 +1,45 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "message_pack.h"
+#include <string.h>
+
+// the frame being filled, each message prefixed by its length in bytes
+static uint8_t frame[MAX_MESSAGE_SIZE];
+static size_t fill = 0;
+
+int PackedMessageFlush(void) {
+  if (fill == 0) return 0;
+  // a length byte of zero marks the end of the packed messages
+  memset(frame + fill, 0, sizeof(frame) - fill);
+  if (ScheduleMessage(frame, sizeof(frame)) < 0) return -1;
+  // cleared only once the frame has been accepted, a failed flush keeps the
+  // staged messages so it can be retried
+  fill = 0;
+  return 0;
+}
+
+int PackedMessageSchedule(const void *Message, size_t MessageSize) {
+  if (MessageSize == 0 || MessageSize > MESSAGE_PACK_MAX) return -1;
+  if (fill + 1 + MessageSize > sizeof(frame) && PackedMessageFlush() != 0)
+    return -1;
+  frame[fill] = MessageSize;
+  memcpy(frame + fill + 1, Message, MessageSize);
+  fill += 1 + MessageSize;
+  return 0;
+}
+
+size_t PackedMessageBytesFree(void) {
+  if (fill + 1 >= sizeof(frame)) return 0;
+  return sizeof(frame) - fill - 1;
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Packs small messages into shared transmit frames. ScheduleMessage consumes
+// MAX_MESSAGE_SIZE bytes of queue space regardless of the payload size, so an
+// application sending small readings wastes most of its queue capacity and
+// airtime on padding. This layer coalesces messages into MAX_MESSAGE_SIZE
+// frames, each message prefixed with a single length byte and the remainder
+// of the frame zero filled, so the unpacker (unpack.py) can split frames back
+// into the original messages.
+
+#ifndef MESSAGE_PACK_H
+#define MESSAGE_PACK_H
+
+#include "myriota_user_api.h"
+
+/// Maximum size in bytes of an individual packed message, one byte of each
+/// frame is the length prefix.
+#define MESSAGE_PACK_MAX (MAX_MESSAGE_SIZE - 1)
+
+/// Append a message of up to #MESSAGE_PACK_MAX bytes to the current frame.
+/// If the message does not fit the frame is scheduled for transmission first.
+/// Returns 0 if succeeded and -1 if the size is invalid or scheduling failed.
+int PackedMessageSchedule(const void *Message, size_t MessageSize);
+
+/// Schedule a partially filled frame for transmission, for example
+/// immediately before a satellite transmit opportunity. Does nothing if the
+/// frame is empty. Returns 0 if succeeded and -1 if scheduling failed.
+int PackedMessageFlush(void);
+
+/// Returns the number of message bytes, excluding the length prefix, that fit
+/// in the current frame before it is scheduled.
+size_t PackedMessageBytesFree(void);
+
+#endif  // MESSAGE_PACK_H
@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Unpacker for the packed messages example. Splits a frame into the packed
+# readings using the length byte before each one, a length of zero marks the
+# end of the frame.
+# Usage:
+# unpack.py -x 0601001f09a40c0602001c09a40c000000000000
+# or
+# echo "0601001f09a40c0602001c09a40c000000000000" | unpack.py
+
+import argparse
+import struct
+import json
+import fileinput
+
+
+def unpack(packet):
+    frame = bytearray.fromhex(packet)
+    readings = []
+    pos = 0
+    while pos < len(frame) and frame[pos] != 0:
+        length = frame[pos]
+        num, temperature, voltage = struct.unpack(
+            "<HhH", frame[pos + 1 : pos + 1 + length]
+        )
+        readings.append(
+            {
+                "Sequence number": num,
+                "Temperature": temperature / 100.0,
+                "Battery voltage": voltage,
+            }
+        )
+        pos = pos + 1 + length
+    return readings
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Unpack hexadecimal data from packed messages example.",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    parser.add_argument(
+        "-x", "--hex", type=str, default="-", help="Packet data in hexadecimal format"
+    )
+    args = parser.parse_args()
+
+    d = []
+    if args.hex == "-":
+        for line in fileinput.input():
+            d = d + unpack(line.strip())
+    else:
+        d = d + unpack(args.hex)
+
+    print(json.dumps(d))
@@ -12,21 +12,44 @@
 // limitations under the License.
 
 // A simple tracker application. Sends messages to satellite
-// containing message sequence number, the current device
-// location, and the time.
+// containing message sequence number, device locations, and the time.
+// Fixes are batched: a message carries a full first fix and, when the
+// movement and interval fit the delta fields, a second fix delta encoded
+// against it, so two positions cost one queue slot and one transmission.
+// A fix is held for one reporting interval waiting for its partner, so
+// positions arrive one interval later than they would unbatched.
 
 #include "myriota_user_api.h"
 
-// Format of the messages to be transmitted. Values are little endian
+// Format of the messages to be transmitted, 20 bytes exactly. Values are
+// little endian. When count is 1 the delta fields are zero. The second fix,
+// when present, is the first plus the deltas: latitude and longitude deltas
+// are in 1e-5 degree units (about 1.1 m) covering +/-0.32 degrees of
+// movement, the time delta is in seconds covering 18 hours.
 typedef struct {
-  uint16_t sequence_number;
+  uint8_t sequence_number;  // of the first fix
+  uint8_t count;            // fixes in this message, 1 or 2
   int32_t latitude;   // scaled by 1e7, e.g. -891234567 (south 89.1234567)
   int32_t longitude;  // scaled by 1e7, e.g. 1791234567 (east 179.1234567)
-  uint32_t time;      // epoch timestamp of last fix
+  uint32_t time;      // epoch timestamp of first fix
+  int16_t delta_latitude;
+  int16_t delta_longitude;
+  uint16_t delta_time;
 } __attribute__((packed)) tracker_message;
 
+static tracker_message pending;
+static bool has_pending = false;
+
+static void SendPending(void) {
+  ScheduleMessage((void *)&pending, sizeof(pending));
+  printf("Scheduled message: %u %u fixes from %f %f %u\n",
+         pending.sequence_number, pending.count, pending.latitude * 1e-7,
+         pending.longitude * 1e-7, (unsigned int)pending.time);
+  has_pending = false;
+}
+
 static time_t Tracker(void) {
-  static unsigned int sequence_number = 0;
+  static uint8_t sequence_number = 0;
 
   if (GNSSFix()) printf("Failed to get GNSS Fix, using last known fix\n");
 
@@ -36,13 +59,32 @@ static time_t Tracker(void) {
     time_t timestamp;
     LocationGet(&lat, &lon, &timestamp);
 
-    const tracker_message message = {sequence_number, lat, lon, timestamp};
-
-    ScheduleMessage((void *)&message, sizeof(message));
-
-    printf("Scheduled message: %u %f %f %u\n", sequence_number, lat * 1e-7,
-           lon * 1e-7, (unsigned int)timestamp);
-
+    bool batched = false;
+    if (has_pending) {
+      // second fix as a delta when it fits the reduced width fields,
+      // otherwise the pending fix goes out alone and this one starts a new
+      // message
+      // 64 bit differences, the longitude delta can reach 3.6e9 in 1e-7
+      // degree units for fixes straddling the antimeridian
+      const int64_t dlat = ((int64_t)lat - pending.latitude) / 100;
+      const int64_t dlon = ((int64_t)lon - pending.longitude) / 100;
+      const int64_t dtime = (int64_t)timestamp - pending.time;
+      if (dlat >= INT16_MIN && dlat <= INT16_MAX && dlon >= INT16_MIN &&
+          dlon <= INT16_MAX && dtime >= 0 && dtime <= UINT16_MAX) {
+        pending.count = 2;
+        pending.delta_latitude = dlat;
+        pending.delta_longitude = dlon;
+        pending.delta_time = dtime;
+        batched = true;
+      }
+      SendPending();
+    }
+    if (!batched) {
+      const tracker_message message = {sequence_number, 1, lat, lon,
+                                       timestamp,       0, 0,   0};
+      pending = message;
+      has_pending = true;
+    }
     sequence_number++;
   }
 
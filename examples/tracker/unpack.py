@@ -14,11 +14,13 @@
 # limitations under the License.
 
 
-# Unpacker for the tracker example.
+# Unpacker for the tracker example. A message holds a full first fix and
+# optionally a second fix delta encoded against it, see tracker_message in
+# main.c.
 # Usage:
-# unpack.py -x 0000aea02feb06fe9d52b89f3e5ccccccccccccccc
+# unpack.py -x 0002058c2feb51019e5280ad2a5c6400c8ff8403
 # or
-# echo "0000aea02feb06fe9d52b89f3e5ccccccccccccccc" | unpack.py
+# echo "0002058c2feb51019e5280ad2a5c6400c8ff8403" | unpack.py
 
 import argparse
 import struct
@@ -27,8 +29,10 @@ import fileinput
 
 
 def unpack(packet):
-    num, lat, lon, timestamp = struct.unpack("<HiiI", bytearray.fromhex(packet[0:28]))
-    return [
+    num, count, lat, lon, timestamp, dlat, dlon, dtime = struct.unpack(
+        "<BBiiIhhH", bytearray.fromhex(packet[0:40])
+    )
+    fixes = [
         {
             "Sequence number": num,
             "Latitude": lat / 1e7,
@@ -36,6 +40,17 @@ def unpack(packet):
             "Timestamp": timestamp,
         }
     ]
+    if count > 1:
+        # deltas are in 1e-5 degree and second units
+        fixes.append(
+            {
+                "Sequence number": (num + 1) % 256,
+                "Latitude": (lat + dlat * 100) / 1e7,
+                "Longitude": (lon + dlon * 100) / 1e7,
+                "Timestamp": timestamp + dtime,
+            }
+        )
+    return fixes
 
 
 if __name__ == "__main__":
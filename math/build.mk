@@ -12,6 +12,24 @@
 # limitations under the License.
 
 
+
+# Set MATH_SIMD=0 to force the scalar fallback kernels in the math library.
+# By default the SIMD kernels use whatever vector instruction sets are enabled
+# by the compiler flags (SSE/AVX on x86, NEON on 64-bit ARM), e.g. append
+# -mavx or -march=native to APPEND_FLAGS to widen the lanes.
+MATH_SIMD ?= 1
+ifeq ($(MATH_SIMD),0)
+CFLAGS += -DMYRIOTA_MATH_NO_SIMD
+CXXFLAGS += -DMYRIOTA_MATH_NO_SIMD
+endif
+
+# Set MATH_EXCEPTIONS=0 to replace throwing error paths in the math library
+# with no-throw status returns, for firmware built with -fno-exceptions.
+MATH_EXCEPTIONS ?= 1
+ifeq ($(MATH_EXCEPTIONS),0)
+CXXFLAGS += -DMYRIOTA_MATH_NO_EXCEPTIONS
+endif
+
 allsourceindirs = $(foreach dir,$(1), $(foreach ext, $(2), $(wildcard $(dir)/*.$(ext))))
 commonsourceindirs = $(foreach dir,$(1), $(foreach ext, $(2), $(wildcard $(dir)/*common.$(ext))))
 
@@ -13,6 +13,7 @@
 
 #include "math/myriotacommon.h"
 #include <assert.h>
+#include <pthread.h>
 #include <stdio.h>
 
 // Convert hexidecimal character to number in the interval [0,15]
@@ -52,12 +53,59 @@ int myriota_hex_to_byte(const char *h, uint8_t *b) {
   return 2;
 }
 
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SSSE3__)
+#include <tmmintrin.h>
+
+// Convert 8 bytes to 16 hex characters by nibble lookup
+static void hex_encode_block(const uint8_t *in, char *out) {
+  const __m128i lut =
+      _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b',
+                    'c', 'd', 'e', 'f');
+  const __m128i v = _mm_loadl_epi64((const __m128i *)in);
+  const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+  const __m128i lo = _mm_and_si128(v, _mm_set1_epi8(0x0F));
+  _mm_storeu_si128((__m128i *)out,
+                   _mm_shuffle_epi8(lut, _mm_unpacklo_epi8(hi, lo)));
+}
+
+// Convert and validate 16 hex characters into 8 bytes. Returns 1 on success
+// and 0, storing nothing, if any character is not hexadecimal
+static int hex_decode_block(const char *in, uint8_t *out) {
+  const __m128i x = _mm_loadu_si128((const __m128i *)in);
+  // fold upper case onto lower case, leaves digits unchanged
+  const __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+  // digits already carry the case bit so they are classified on the raw
+  // input, folding first would let the control bytes 0x10-0x19 masquerade
+  // as '0'-'9'. Only the letter ranges collapse under the fold
+  const __m128i is_digit =
+      _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('0' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), x));
+  const __m128i is_alpha =
+      _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                    _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), lower));
+  if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF) return 0;
+  // nibble values, '0'-'9' offset by 0x30, 'a'-'f' by 0x61 - 10
+  const __m128i val = _mm_or_si128(
+      _mm_and_si128(_mm_sub_epi8(lower, _mm_set1_epi8('0')), is_digit),
+      _mm_and_si128(_mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)), is_alpha));
+  // pairs to bytes, high nibble scaled by 16 and added to the low
+  const __m128i w = _mm_maddubs_epi16(val, _mm_set1_epi16(0x0110));
+  _mm_storel_epi64((__m128i *)out, _mm_packus_epi16(w, w));
+  return 1;
+}
+#endif
+
 int myriota_n_hex_to_buf(const char *s, const size_t n, void *buf) {
   uint8_t *bytes = (uint8_t *)buf;
   const size_t slen = strlen(s);
   const size_t m = n > slen ? slen : n;
   if (m % 2 != 0) return 0;  // n must be even
-  for (const char *c = s; c < s + m; c += 2, bytes++)
+  const char *c = s;
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SSSE3__)
+  for (; c + 16 <= s + m; c += 16, bytes += 8)
+    if (!hex_decode_block(c, bytes)) return 0;  // scan failed
+#endif
+  for (; c < s + m; c += 2, bytes++)
     if (myriota_hex_to_byte(c, bytes) != 2) return 0;  // scan failed
   return m;                                            // success
 }
@@ -68,7 +116,12 @@ int myriota_hex_to_buf(const char *s, void *buf) {
 
 int myriota_buf_to_hex(const void *buf, const size_t buf_size, char *s) {
   const uint8_t *bytes = (const uint8_t *)buf;
-  for (size_t i = 0; i < buf_size; i++) s += sprintf(s, "%02x", bytes[i]);
+  size_t i = 0;
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SSSE3__)
+  for (; i + 8 <= buf_size; i += 8, s += 16) hex_encode_block(bytes + i, s);
+  if (i > 0) *s = '\0';  // rewritten by sprintf when a tail follows
+#endif
+  for (; i < buf_size; i++) s += sprintf(s, "%02x", bytes[i]);
   return buf_size * 2;
 }
 
@@ -86,20 +139,59 @@ static uint32_t reverse_bits(uint32_t x) {
   return x;
 }
 
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+// The CRC is maintained in the bit-reflected domain where the 0x04C11DB7
+// polynomial becomes 0xEDB88320 and the bit-at-a-time loop becomes the
+// standard byte table recursion. State s relates to the crc variable of the
+// original shift register formulation by s = reverse_bits(crc), making the
+// result identical for all inputs including nonzero offset.
+static uint32_t crc_tab[8][256];
+
+static void crc32_tab_init(void) {
+  for (int i = 0; i < 256; i++) {
+    uint32_t c = i;
+    for (int j = 0; j < 8; j++) c = (c >> 1) ^ ((c & 1) ? 0xEDB88320 : 0);
+    crc_tab[0][i] = c;
+  }
+  // slice-by-8 tables, crc_tab[t] advances a byte t+1 positions
+  for (int i = 0; i < 256; i++)
+    for (int t = 1; t < 8; t++)
+      crc_tab[t][i] =
+          (crc_tab[t - 1][i] >> 8) ^ crc_tab[0][crc_tab[t - 1][i] & 0xff];
+}
+
 uint32_t myriota_crc32(const void *data, size_t length, uint32_t offset) {
-  uint32_t crc = ~offset;
-  const uint8_t *bytes = (uint8_t *)data;
-  for (int i = 0; i < length; i++) {
-    uint32_t b = reverse_bits(bytes[i]);
-    for (int j = 0; j < 8; j++) {
-      if ((int32_t)(crc ^ b) < 0)
-        crc = (crc << 1) ^ 0x04C11DB7;
-      else
-        crc = crc << 1;
-      b = b << 1;
-    }
+  // pthread_once so concurrent first calls from threaded tools are safe
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
+  pthread_once(&once, crc32_tab_init);
+  uint32_t s = ~reverse_bits(offset);
+  const uint8_t *p = (const uint8_t *)data;
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__ARM_FEATURE_CRC32)
+  // ARMv8 CRC extension implements this polynomial directly
+  for (; length >= 8; p += 8, length -= 8) {
+    uint64_t x;
+    memcpy(&x, p, 8);
+    s = __crc32d(s, x);
   }
-  return reverse_bits(~crc);
+#else
+  // slice-by-8, two 32-bit words per step with eight independent
+  // table lookups
+  for (; length >= 8; p += 8, length -= 8) {
+    const uint32_t lo = s ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 |
+                             (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+    const uint32_t hi = (uint32_t)p[4] | (uint32_t)p[5] << 8 |
+                        (uint32_t)p[6] << 16 | (uint32_t)p[7] << 24;
+    s = crc_tab[7][lo & 0xff] ^ crc_tab[6][(lo >> 8) & 0xff] ^
+        crc_tab[5][(lo >> 16) & 0xff] ^ crc_tab[4][lo >> 24] ^
+        crc_tab[3][hi & 0xff] ^ crc_tab[2][(hi >> 8) & 0xff] ^
+        crc_tab[1][(hi >> 16) & 0xff] ^ crc_tab[0][hi >> 24];
+  }
+#endif
+  for (; length > 0; length--) s = (s >> 8) ^ crc_tab[0][(s ^ *p++) & 0xff];
+  return ~s;
 }
 
 static int cmp_double(const void *ap, const void *bp) {
@@ -177,14 +269,6 @@ static const uint32_t k[] = {
     0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
 
-struct buffer_state {
-  const uint8_t *p;
-  size_t len;
-  size_t total_len;
-  int single_one_delivered; /* bool */
-  int total_len_delivered;  /* bool */
-};
-
 static inline uint32_t right_rot(uint32_t value, unsigned int count) {
   /*
    * Defined behaviour in standard C for all count where 0 < count < 32,
@@ -193,172 +277,191 @@ static inline uint32_t right_rot(uint32_t value, unsigned int count) {
   return value >> count | value << (32 - count);
 }
 
-static void init_buf_state(struct buffer_state *state, const void *input,
-                           size_t len) {
-  state->p = input;
-  state->len = len;
-  state->total_len = len;
-  state->single_one_delivered = 0;
-  state->total_len_delivered = 0;
+// Compress one 64-byte chunk into the hash state h. Hardware backends are
+// used where the target enables them (x86 SHA-NI, ARMv8 SHA2 extension),
+// otherwise the portable compression function. MYRIOTA_MATH_NO_SIMD forces
+// the portable path.
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SHA__)
+
+#include <immintrin.h>
+
+static void sha256_compress(uint32_t h[8], const uint8_t *p) {
+  const __m128i shuf =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+  __m128i tmp = _mm_loadu_si128((const __m128i *)&h[0]);
+  __m128i state1 = _mm_loadu_si128((const __m128i *)&h[4]);
+  tmp = _mm_shuffle_epi32(tmp, 0xB1);                   /* CDAB */
+  state1 = _mm_shuffle_epi32(state1, 0x1B);             /* EFGH */
+  __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);     /* ABEF */
+  state1 = _mm_blend_epi16(state1, tmp, 0xF0);          /* CDGH */
+  const __m128i save0 = state0, save1 = state1;
+  __m128i m[4];
+  for (int q = 0; q < 16; q++) {
+    if (q < 4)
+      m[q] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 16 * q)),
+                              shuf);
+    else  // next four words of the message schedule
+      m[q & 3] = _mm_sha256msg2_epu32(
+          _mm_add_epi32(_mm_sha256msg1_epu32(m[q & 3], m[(q + 1) & 3]),
+                        _mm_alignr_epi8(m[(q + 3) & 3], m[(q + 2) & 3], 4)),
+          m[(q + 3) & 3]);
+    __m128i w =
+        _mm_add_epi32(m[q & 3], _mm_loadu_si128((const __m128i *)&k[4 * q]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, w);
+    w = _mm_shuffle_epi32(w, 0x0E);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, w);
+  }
+  state0 = _mm_add_epi32(state0, save0);
+  state1 = _mm_add_epi32(state1, save1);
+  tmp = _mm_shuffle_epi32(state0, 0x1B);                /* FEBA */
+  state1 = _mm_shuffle_epi32(state1, 0xB1);             /* DCHG */
+  _mm_storeu_si128((__m128i *)&h[0], _mm_blend_epi16(tmp, state1, 0xF0));
+  _mm_storeu_si128((__m128i *)&h[4], _mm_alignr_epi8(state1, tmp, 8));
 }
 
-/* Return value: bool */
-static int calc_chunk(uint8_t chunk[CHUNK_SIZE], struct buffer_state *state) {
-  size_t space_in_chunk;
-
-  if (state->total_len_delivered) {
-    return 0;
+#elif !defined(MYRIOTA_MATH_NO_SIMD) && defined(__ARM_FEATURE_SHA2) && \
+    defined(__aarch64__)
+
+#include <arm_neon.h>
+
+static void sha256_compress(uint32_t h[8], const uint8_t *p) {
+  uint32x4_t state0 = vld1q_u32(&h[0]);
+  uint32x4_t state1 = vld1q_u32(&h[4]);
+  const uint32x4_t save0 = state0, save1 = state1;
+  uint32x4_t m[4];
+  for (int q = 0; q < 16; q++) {
+    if (q < 4)
+      m[q] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 16 * q)));
+    else  // next four words of the message schedule
+      m[q & 3] = vsha256su1q_u32(vsha256su0q_u32(m[q & 3], m[(q + 1) & 3]),
+                                 m[(q + 2) & 3], m[(q + 3) & 3]);
+    const uint32x4_t w = vaddq_u32(m[q & 3], vld1q_u32(&k[4 * q]));
+    const uint32x4_t t = state0;
+    state0 = vsha256hq_u32(state0, state1, w);
+    state1 = vsha256h2q_u32(state1, t, w);
   }
+  vst1q_u32(&h[0], vaddq_u32(state0, save0));
+  vst1q_u32(&h[4], vaddq_u32(state1, save1));
+}
 
-  if (state->len >= CHUNK_SIZE) {
-    memcpy(chunk, state->p, CHUNK_SIZE);
-    state->p += CHUNK_SIZE;
-    state->len -= CHUNK_SIZE;
-    return 1;
-  }
+#else
 
-  memcpy(chunk, state->p, state->len);
-  chunk += state->len;
-  space_in_chunk = CHUNK_SIZE - state->len;
-  state->p += state->len;
-  state->len = 0;
-
-  /* If we are here, space_in_chunk is one at minimum. */
-  if (!state->single_one_delivered) {
-    *chunk++ = 0x80;
-    space_in_chunk -= 1;
-    state->single_one_delivered = 1;
-  }
+static void sha256_compress(uint32_t h[8], const uint8_t *chunk) {
+  uint32_t ah[8];
+  int i;
 
   /*
-   * Now:
-   * - either there is enough space left for the total length, and we can
-   * conclude,
-   * - or there is too little space left, and we have to pad the rest of this
-   * chunk with zeroes. In the latter case, we will conclude at the next
-   * invokation of this function.
+   * create a 64-entry message schedule array w[0..63] of 32-bit words
+   * copy chunk into first 16 words w[0..15] of the message schedule array
    */
-  if (space_in_chunk >= TOTAL_LEN_LEN) {
-    const size_t left = space_in_chunk - TOTAL_LEN_LEN;
-    size_t len = state->total_len;
-    int i;
-    memset(chunk, 0x00, left);
-    chunk += left;
-
-    /* Storing of len * 8 as a big endian 64-bit without overflow. */
-    chunk[7] = (uint8_t)(len << 3);
-    len >>= 5;
-    for (i = 6; i >= 0; i--) {
-      chunk[i] = (uint8_t)len;
-      len >>= 8;
-    }
-    state->total_len_delivered = 1;
-  } else {
-    memset(chunk, 0x00, space_in_chunk);
+  uint32_t w[64];
+  const uint8_t *p = chunk;
+
+  for (i = 0; i < 16; i++) {
+    w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 |
+           (uint32_t)p[3];
+    p += 4;
   }
 
-  return 1;
+  /* Extend the first 16 words into the remaining 48 words w[16..63] of the
+   * message schedule array: */
+  for (i = 16; i < 64; i++) {
+    const uint32_t s0 =
+        right_rot(w[i - 15], 7) ^ right_rot(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    const uint32_t s1 =
+        right_rot(w[i - 2], 17) ^ right_rot(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  /* Initialize working variables to current hash value: */
+  for (i = 0; i < 8; i++) ah[i] = h[i];
+
+  /* Compression function main loop: */
+  for (i = 0; i < 64; i++) {
+    const uint32_t s1 =
+        right_rot(ah[4], 6) ^ right_rot(ah[4], 11) ^ right_rot(ah[4], 25);
+    const uint32_t ch = (ah[4] & ah[5]) ^ (~ah[4] & ah[6]);
+    const uint32_t temp1 = ah[7] + s1 + ch + k[i] + w[i];
+    const uint32_t s0 =
+        right_rot(ah[0], 2) ^ right_rot(ah[0], 13) ^ right_rot(ah[0], 22);
+    const uint32_t maj = (ah[0] & ah[1]) ^ (ah[0] & ah[2]) ^ (ah[1] & ah[2]);
+    const uint32_t temp2 = s0 + maj;
+
+    ah[7] = ah[6];
+    ah[6] = ah[5];
+    ah[5] = ah[4];
+    ah[4] = ah[3] + temp1;
+    ah[3] = ah[2];
+    ah[2] = ah[1];
+    ah[1] = ah[0];
+    ah[0] = temp1 + temp2;
+  }
+
+  /* Add the compressed chunk to the current hash value: */
+  for (i = 0; i < 8; i++) h[i] += ah[i];
 }
 
-/*
- * Limitations:
- * - Since input is a pointer in RAM, the data to hash should be in RAM, which
- * could be a problem for large data sizes.
- * - SHA algorithms theoretically operate on bit strings. However, this
- * implementation has no support for bit string lengths that are not multiples
- * of eight, and it really operates on arrays of bytes. In particular, the len
- * parameter is a number of bytes.
- */
-void myriota_sha256(const void *input, size_t len, uint8_t hash[32]) {
-  /*
-   * Note 1: All integers (expect indexes) are 32-bit unsigned integers and
-   * addition is calculated modulo 2^32. Note 2: For each round, there is one
-   * round constant k[i] and one entry in the message schedule array w[i], 0 = i
-   * = 63 Note 3: The compression function uses 8 working variables, a through h
-   * Note 4: Big-endian convention is used when expressing the constants in this
-   * pseudocode, and when parsing message block data from bytes to words, for
-   * example, the first word of the input message "abc" after padding is
-   * 0x61626380
-   */
+#endif
 
+void myriota_sha256_init(myriota_sha256_context *state) {
   /*
    * Initialize hash values:
    * (first 32 bits of the fractional parts of the square roots of the first 8
    * primes 2..19):
    */
-  uint32_t h[] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-                  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
-  int i, j;
-
-  /* 512-bit chunks is what we will operate on. */
-  uint8_t chunk[64];
-
-  struct buffer_state state;
-
-  init_buf_state(&state, input, len);
-
-  while (calc_chunk(chunk, &state)) {
-    uint32_t ah[8];
-
-    /*
-     * create a 64-entry message schedule array w[0..63] of 32-bit words
-     * (The initial values in w[0..63] don't matter, so many implementations
-     * zero them here) copy chunk into first 16 words w[0..15] of the message
-     * schedule array
-     */
-    uint32_t w[64];
-    const uint8_t *p = chunk;
-
-    memset(w, 0x00, sizeof w);
-    for (i = 0; i < 16; i++) {
-      w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 |
-             (uint32_t)p[3];
-      p += 4;
-    }
-
-    /* Extend the first 16 words into the remaining 48 words w[16..63] of the
-     * message schedule array: */
-    for (i = 16; i < 64; i++) {
-      const uint32_t s0 =
-          right_rot(w[i - 15], 7) ^ right_rot(w[i - 15], 18) ^ (w[i - 15] >> 3);
-      const uint32_t s1 =
-          right_rot(w[i - 2], 17) ^ right_rot(w[i - 2], 19) ^ (w[i - 2] >> 10);
-      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
-    }
-
-    /* Initialize working variables to current hash value: */
-    for (i = 0; i < 8; i++) ah[i] = h[i];
-
-    /* Compression function main loop: */
-    for (i = 0; i < 64; i++) {
-      const uint32_t s1 =
-          right_rot(ah[4], 6) ^ right_rot(ah[4], 11) ^ right_rot(ah[4], 25);
-      const uint32_t ch = (ah[4] & ah[5]) ^ (~ah[4] & ah[6]);
-      const uint32_t temp1 = ah[7] + s1 + ch + k[i] + w[i];
-      const uint32_t s0 =
-          right_rot(ah[0], 2) ^ right_rot(ah[0], 13) ^ right_rot(ah[0], 22);
-      const uint32_t maj = (ah[0] & ah[1]) ^ (ah[0] & ah[2]) ^ (ah[1] & ah[2]);
-      const uint32_t temp2 = s0 + maj;
-
-      ah[7] = ah[6];
-      ah[6] = ah[5];
-      ah[5] = ah[4];
-      ah[4] = ah[3] + temp1;
-      ah[3] = ah[2];
-      ah[2] = ah[1];
-      ah[1] = ah[0];
-      ah[0] = temp1 + temp2;
-    }
-
-    /* Add the compressed chunk to the current hash value: */
-    for (i = 0; i < 8; i++) h[i] += ah[i];
+  const uint32_t init[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                            0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  memcpy(state->h, init, sizeof(init));
+  state->total_len = 0;
+}
+
+void myriota_sha256_update(myriota_sha256_context *state, const void *input,
+                           size_t len) {
+  const uint8_t *p = (const uint8_t *)input;
+  const size_t fill = state->total_len % CHUNK_SIZE;
+  state->total_len += len;
+  if (fill) {  // complete the buffered partial chunk first
+    const size_t n = CHUNK_SIZE - fill < len ? CHUNK_SIZE - fill : len;
+    memcpy(state->block + fill, p, n);
+    p += n;
+    len -= n;
+    if (fill + n < CHUNK_SIZE) return;
+    sha256_compress(state->h, state->block);
   }
+  for (; len >= CHUNK_SIZE; p += CHUNK_SIZE, len -= CHUNK_SIZE)
+    sha256_compress(state->h, p);
+  memcpy(state->block, p, len);
+}
+
+void myriota_sha256_final(myriota_sha256_context *state,
+                          uint8_t hash[SHA256_BYTES]) {
+  const size_t fill = state->total_len % CHUNK_SIZE;
+  state->block[fill] = 0x80;
+  if (fill >= CHUNK_SIZE - TOTAL_LEN_LEN) {  // length won't fit, extra chunk
+    memset(state->block + fill + 1, 0, CHUNK_SIZE - fill - 1);
+    sha256_compress(state->h, state->block);
+    memset(state->block, 0, CHUNK_SIZE - TOTAL_LEN_LEN);
+  } else {
+    memset(state->block + fill + 1, 0, CHUNK_SIZE - TOTAL_LEN_LEN - fill - 1);
+  }
+  /* message length in bits as big endian 64-bit */
+  const uint64_t bits = state->total_len << 3;
+  for (int i = 0; i < TOTAL_LEN_LEN; i++)
+    state->block[CHUNK_SIZE - 1 - i] = (uint8_t)(bits >> (8 * i));
+  sha256_compress(state->h, state->block);
 
   /* Produce the final hash value (big-endian): */
-  for (i = 0, j = 0; i < 8; i++) {
-    hash[j++] = (uint8_t)(h[i] >> 24);
-    hash[j++] = (uint8_t)(h[i] >> 16);
-    hash[j++] = (uint8_t)(h[i] >> 8);
-    hash[j++] = (uint8_t)h[i];
+  for (int i = 0, j = 0; i < 8; i++) {
+    hash[j++] = (uint8_t)(state->h[i] >> 24);
+    hash[j++] = (uint8_t)(state->h[i] >> 16);
+    hash[j++] = (uint8_t)(state->h[i] >> 8);
+    hash[j++] = (uint8_t)state->h[i];
   }
 }
+
+void myriota_sha256(const void *input, size_t len, uint8_t hash[32]) {
+  myriota_sha256_context state;
+  myriota_sha256_init(&state);
+  myriota_sha256_update(&state, input, len);
+  myriota_sha256_final(&state, hash);
+}
@@ -116,6 +116,23 @@ int32_t myriota_median_int32(int32_t *a, const size_t nitems);
 // Output written to hash of size SHA256_BYTES
 void myriota_sha256(const void *input, size_t len, uint8_t hash[SHA256_BYTES]);
 
+// Streaming SHA-256. Hashes data incrementally so large inputs need not be
+// buffered whole in memory: call myriota_sha256_init, then
+// myriota_sha256_update any number of times, then myriota_sha256_final to
+// write the digest. The context must not be used again after final without
+// another init.
+typedef struct {
+  uint32_t h[8];      // running hash state
+  uint8_t block[64];  // partial input block
+  uint64_t total_len; // total bytes hashed
+} myriota_sha256_context;
+
+void myriota_sha256_init(myriota_sha256_context *state);
+void myriota_sha256_update(myriota_sha256_context *state, const void *input,
+                           size_t len);
+void myriota_sha256_final(myriota_sha256_context *state,
+                          uint8_t hash[SHA256_BYTES]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -13,6 +13,7 @@
 
 #include "math/myriotamath.h"
 #include <assert.h>
+#include <float.h>
 #include <stdio.h>
 
 double myriota_modulus(const double arg1, const double arg2) {
@@ -108,18 +109,65 @@ void myriota_set_bit(const unsigned int n, const unsigned int value,
   if (value != 0) x[d] |= (1 << r);
 }
 
+// copy len bits starting at bit number from_start of from to bit number
+// to_start of to, bit numbering as in myriota_get_bit. Single bits are moved
+// only until the destination reaches a byte boundary, then whole 64-bit words
+// and bytes are shifted across, so long runs cost a few operations per word
+// rather than per bit.
+static void copy_bits(const uint8_t *from, unsigned int from_start, uint8_t *to,
+                      unsigned int to_start, unsigned int len) {
+  while (len > 0 && to_start % 8 != 0) {
+    myriota_set_bit(to_start++, myriota_get_bit(from_start++, from), to);
+    len--;
+  }
+  const unsigned int d = from_start % 8;
+  if (d == 0) {  // source aligned too, straight byte copy
+    memcpy(to + to_start / 8, from + from_start / 8, len / 8);
+    const unsigned int n = len - len % 8;
+    from_start += n;
+    to_start += n;
+    len %= 8;
+  } else {
+    // each aligned destination word gathers a word and a byte of the source,
+    // both containing bits of the run so the reads stay in bounds
+    const uint8_t *f = from + from_start / 8;
+    uint8_t *t = to + to_start / 8;
+    for (; len >= 64; len -= 64, f += 8, t += 8) {
+      uint64_t w = 0;
+      for (int i = 0; i < 8; i++) w = w << 8 | f[i];
+      w = w << d | f[8] >> (8 - d);
+      for (int i = 7; i >= 0; i--) {
+        t[i] = (uint8_t)w;
+        w >>= 8;
+      }
+      from_start += 64;
+      to_start += 64;
+    }
+    for (; len >= 8; len -= 8, f++, t++) {
+      *t = (uint8_t)(f[0] << d | f[1] >> (8 - d));
+      from_start += 8;
+      to_start += 8;
+    }
+  }
+  while (len > 0) {
+    myriota_set_bit(to_start++, myriota_get_bit(from_start++, from), to);
+    len--;
+  }
+}
+
 void myriota_write_bits(const uint8_t *from, uint8_t *to,
                         const unsigned int start, const unsigned int stop) {
-  for (int n = start; n <= stop; n++)
-    myriota_set_bit(n, myriota_get_bit(n - start, from), to);
+  if (stop < start) return;
+  copy_bits(from, 0, to, start, stop - start + 1);
 }
 
 void myriota_read_bits(const uint8_t *from, uint8_t *to,
                        const unsigned int start, const unsigned int stop) {
-  for (int n = start; n <= stop; n++)
-    myriota_set_bit(n - start, myriota_get_bit(n, from), to);
+  if (stop < start) return;
+  copy_bits(from, start, to, 0, stop - start + 1);
 }
 
+
 myriota_complex myriota_polar(double magnitude, double phase) {
   return magnitude * (cos(phase) + I * sin(phase));
 }
@@ -138,6 +186,191 @@ double myriota_complex_real(myriota_complex x) { return creal(x); }
 double myriota_complex_imag(myriota_complex x) { return cimag(x); }
 myriota_complex myriota_complex_conj(myriota_complex x) { return conj(x); }
 
+// index with the low log2n bits reversed, e.g. bit_reverse(1, 3) = 4
+static unsigned int bit_reverse(unsigned int i, unsigned int log2n) {
+  unsigned int r = 0;
+  for (unsigned int b = 0; b < log2n; b++) {
+    r = r << 1 | (i & 1);
+    i >>= 1;
+  }
+  return r;
+}
+
+// in-place bit reversal permutation of x, size elements of width bytes
+static void bit_reverse_permute(void *x, const unsigned int size,
+                                const size_t width) {
+  unsigned int log2n = 0;
+  while ((1u << log2n) < size) log2n++;
+  assert((1u << log2n) == size);  // power of two lengths only
+  for (unsigned int i = 0; i < size; i++) {
+    const unsigned int j = bit_reverse(i, log2n);
+    if (j > i) {
+      uint8_t t[16];
+      assert(width <= sizeof(t));
+      memcpy(t, (uint8_t *)x + i * width, width);
+      memcpy((uint8_t *)x + i * width, (uint8_t *)x + j * width, width);
+      memcpy((uint8_t *)x + j * width, t, width);
+    }
+  }
+}
+
+void myriota_fft(myriota_complex *x, const unsigned int n) {
+  bit_reverse_permute(x, n, sizeof(myriota_complex));
+  for (unsigned int len = 2; len <= n; len <<= 1) {
+    // the twiddle is invariant in i, advance it by recurrence with the j
+    // loop outermost rather than calling myriota_polar per butterfly. The
+    // recurrence drifts by about len epsilon over the stage, far below the
+    // accuracy of the transform itself
+    const myriota_complex wstep = myriota_polar(1.0, -2 * pi / len);
+    myriota_complex w = 1;
+    for (unsigned int j = 0; j < len / 2; j++, w *= wstep) {
+      for (unsigned int i = 0; i < n; i += len) {
+        const myriota_complex u = x[i + j];
+        const myriota_complex v = w * x[i + j + len / 2];
+        x[i + j] = u + v;
+        x[i + j + len / 2] = u - v;
+      }
+    }
+  }
+}
+
+void myriota_ifft(myriota_complex *x, const unsigned int n) {
+  for (unsigned int i = 0; i < n; i++) x[i] = conj(x[i]);
+  myriota_fft(x, n);
+  for (unsigned int i = 0; i < n; i++) x[i] = conj(x[i]) / n;
+}
+
+int myriota_fft_16(myriota_complex_16 *x, const unsigned int n) {
+  bit_reverse_permute(x, n, sizeof(myriota_complex_16));
+  int shifts = 0;
+  for (unsigned int len = 2; len <= n; len <<= 1) {
+    // block floating point, rescale until butterfly growth cannot overflow.
+    // A butterfly output component is bounded by 3 times the largest input
+    // component so the block is kept within [-10922, 10922]
+    int32_t m = 0;
+    for (unsigned int i = 0; i < n; i++) {
+      if (abs(x[i].re) > m) m = abs(x[i].re);
+      if (abs(x[i].im) > m) m = abs(x[i].im);
+    }
+    while (m > INT16_MAX / 3) {
+      for (unsigned int i = 0; i < n; i++) {
+        x[i].re = (x[i].re + 1) >> 1;  // shift with rounding
+        x[i].im = (x[i].im + 1) >> 1;
+      }
+      m = (m + 1) >> 1;
+      shifts++;
+    }
+    // the twiddle is invariant in i, advance cos and sin of 2*pi*j/len by
+    // recurrence with the j loop outermost rather than calling libm per
+    // butterfly. The recurrence error is around len epsilon, well inside
+    // the half unit rounding margin of the 1.15 quantisation
+    const double c = cos(2 * pi / len);
+    const double s = sin(2 * pi / len);
+    double twr = 1.0, twi = 0.0;
+    for (unsigned int j = 0; j < len / 2; j++) {
+      // twiddle factor in 1.15 fixed point
+      const int32_t wr = lround(twr * INT16_MAX);
+      const int32_t wi = lround(-twi * INT16_MAX);
+      for (unsigned int i = 0; i < n; i += len) {
+        const myriota_complex_16 u = x[i + j];
+        const myriota_complex_16 y = x[i + j + len / 2];
+        const int32_t vr = (y.re * wr - y.im * wi + (1 << 14)) >> 15;
+        const int32_t vi = (y.re * wi + y.im * wr + (1 << 14)) >> 15;
+        x[i + j] = (myriota_complex_16){u.re + vr, u.im + vi};
+        x[i + j + len / 2] = (myriota_complex_16){u.re - vr, u.im - vi};
+      }
+      const double t = twr * c - twi * s;
+      twi = twr * s + twi * c;
+      twr = t;
+    }
+  }
+  return shifts;
+}
+
+int myriota_ifft_16(myriota_complex_16 *x, const unsigned int n) {
+  for (unsigned int i = 0; i < n; i++) x[i].im = myriota_clip_16(-x[i].im);
+  const int shifts = myriota_fft_16(x, n);
+  for (unsigned int i = 0; i < n; i++) x[i].im = myriota_clip_16(-x[i].im);
+  return shifts;
+}
+
+// quarter wave of sine in 1.15 fixed point, sin_lut[i] = sin(pi/2 * i/256)
+static const int16_t sin_lut[257] = {
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+    2410, 2611, 2811, 3012, 3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+    4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6786, 6983,
+    7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+    9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+    16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+    20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+    23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+    26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+    31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+    32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+    32757, 32761, 32765, 32766, 32767};
+
+// sine on the first quarter cycle with linear interpolation, p is the phase
+// in [0, 65536] where 65536 is a quarter turn
+static int32_t qsin_16(const uint32_t p) {
+  const uint32_t i = p >> 8;
+  if (i == 256) return sin_lut[256];
+  const int32_t f = p & 0xFF;
+  return sin_lut[i] + (((sin_lut[i + 1] - sin_lut[i]) * f + 128) >> 8);
+}
+
+int16_t myriota_sin_16(const uint32_t theta) {
+  const uint32_t pos = (theta << 2) >> 16;  // position within the quadrant
+  switch (theta >> 30) {
+    case 0:
+      return qsin_16(pos);
+    case 1:
+      return qsin_16(65536 - pos);
+    case 2:
+      return -qsin_16(pos);
+    default:
+      return -qsin_16(65536 - pos);
+  }
+}
+
+int16_t myriota_cos_16(const uint32_t theta) {
+  return myriota_sin_16(theta + (1u << 30));  // quarter turn ahead
+}
+
+void myriota_nco_init_16(myriota_nco_16 *nco, const double f,
+                         const double phase) {
+  nco->phase = (uint32_t)llround((phase - floor(phase)) * 4294967296.0);
+  nco->step = (uint32_t)llround((f - floor(f)) * 4294967296.0);
+}
+
+myriota_complex_16 myriota_nco_next_16(myriota_nco_16 *nco) {
+  const myriota_complex_16 p = {myriota_cos_16(nco->phase),
+                                myriota_sin_16(nco->phase)};
+  nco->phase += nco->step;
+  return p;
+}
+
+void myriota_nco_rotate_16(myriota_nco_16 *nco, const myriota_complex_16 *in,
+                           myriota_complex_16 *out, const size_t n) {
+  for (size_t k = 0; k < n; k++) {
+    const int32_t c = myriota_cos_16(nco->phase);
+    const int32_t s = myriota_sin_16(nco->phase);
+    nco->phase += nco->step;
+    const int32_t re = (in[k].re * c - in[k].im * s + (1 << 14)) >> 15;
+    const int32_t im = (in[k].re * s + in[k].im * c + (1 << 14)) >> 15;
+    out[k] = (myriota_complex_16){myriota_clip_16(re), myriota_clip_16(im)};
+  }
+}
+
 double myriota_sinc(double t) {
   if (fabs(t) < 5e-3) return 1.0 - t * t * (1.0 / 6 - 1.0 / 120 * t * t);
   return sin(pi * t) / (pi * t);
@@ -160,16 +393,50 @@ unsigned long myriota_factorial(unsigned int n) {
 }
 
 double myriota_besselI(int n, double x) {
-  double sum = 0, toadd = 1, tol = 1e-5;
-  int m = 0;
-  while (fabs(toadd) > tol) {
-    unsigned long mf = myriota_factorial(m);
-    unsigned long nf = myriota_factorial(m + n);
-    toadd = pow(x / 2, 2 * m + n) / mf / nf;
-    sum += toadd;
-    m++;
+  n = abs(n);  // I(-n) = I(n)
+  const int negate = x < 0 && (n & 1);  // I(n,-x) = (-1)^n I(n,x)
+  x = fabs(x);
+  if (x == 0) return n == 0 ? 1.0 : 0.0;
+  double r;
+  if (x > fmax(30.0, 2.0 * n * n)) {
+    // asymptotic expansion for large argument,
+    // I(n,x) ~ e^x/sqrt(2 pi x) sum_k (-1)^k a_k(n)/x^k
+    const double mu = 4.0 * n * n;
+    double term = 1, sum = 1;
+    for (int k = 1; k < 40; k++) {
+      const double next =
+          -term * (mu - (2.0 * k - 1) * (2.0 * k - 1)) / (8 * x * k);
+      if (fabs(next) >= fabs(term)) break;  // divergent tail reached
+      term = next;
+      sum += term;
+      if (fabs(term) < 1e-17 * sum) break;
+    }
+    r = exp(x) / sqrt(2 * pi * x) * sum;
+  } else {
+    // Miller's downward recurrence I(k-1) = I(k+1) + (2k/x)I(k) from trial
+    // values well above both the order and the argument, normalised with
+    // the identity I(0,x) + 2 sum_k I(k,x) = e^x
+    const double m = fmax(n, x);
+    const int M = (int)(m + 2 * sqrt(m)) + 30;
+    double Ip = 0, Ic = 1e-30, S = 0, In = 0;
+    for (int k = M; k >= 1; k--) {
+      const double Im = Ip + (2.0 * k / x) * Ic;
+      S += 2 * Ic;
+      if (k == n) In = Ic;
+      Ip = Ic;
+      Ic = Im;
+      if (fabs(Ic) > 1e250) {  // rescale to avoid overflow of trial values
+        Ic *= 1e-250;
+        Ip *= 1e-250;
+        S *= 1e-250;
+        In *= 1e-250;
+      }
+    }
+    S += Ic;  // the k = 0 term
+    if (n == 0) In = Ic;
+    r = In / S * exp(x);
   }
-  return sum;
+  return negate ? -r : r;
 }
 
 // converts integer in the range 0 - 63 to a base64 character.
@@ -195,8 +462,8 @@ int myriota_base64_to_number(char b) {
   return -1;
 }
 
-int myriota_n_base64_to_buf(const char *s, const size_t n, void *buf) {
-  if (n % 4 != 0) return -1;  // only multiples of 4 supported
+// scalar base64 group codecs, also the tail of the SIMD paths below
+static int base64_decode_scalar(const char *s, const size_t n, uint8_t *buf) {
   for (unsigned int i = 0; i < n * 6; i++) {
     const int b = myriota_base64_to_number(s[i / 6]);
     if (b < 0) return -1;
@@ -207,12 +474,8 @@ int myriota_n_base64_to_buf(const char *s, const size_t n, void *buf) {
   return n;
 }
 
-int myriota_base64_to_buf(const char *s, void *buf) {
-  return myriota_n_base64_to_buf(s, strlen(s), buf);
-}
-
-int myriota_buf_to_base64(const void *buf, const size_t buf_size, char *s) {
-  if (buf_size % 3 != 0) return -1;  // only multiples of 3 supported
+static int base64_encode_scalar(const uint8_t *buf, const size_t buf_size,
+                                char *s) {
   uint8_t n = 0;
   int count = 0;
   for (unsigned int i = 0; i < buf_size * 8; i++) {
@@ -224,12 +487,188 @@ int myriota_buf_to_base64(const void *buf, const size_t buf_size, char *s) {
       n = 0;
     }
   }
-  s[count] = '\0';
   return count;
 }
 
 static const char *zbase32 = "ybndrfg8ejkmcpqxot1uwisza345h769";
 
+// SIMD block codecs for base64 and zbase32. Groups are translated 16 bytes at
+// a time with table-free shuffles (the lookups live in vector registers, not
+// memory tables), bit-exact with the scalar group codecs that handle the
+// remainder. Built only where SSSE3 byte shuffles are available, see
+// MATH_SIMD in math/build.mk.
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SSSE3__)
+#include <immintrin.h>
+
+// encode 12 bytes of in as 16 base64 characters, reads 16 bytes of in
+static void base64_encode_block(const uint8_t *in, char *out) {
+  // spread each 3-byte group over 4 bytes then isolate the four 6-bit fields
+  // with masked 16-bit multiplies (shifts by a per-lane constant)
+  const __m128i x = _mm_shuffle_epi8(
+      _mm_loadu_si128((const __m128i *)in),
+      _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  const __m128i t0 = _mm_and_si128(x, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(x, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  const __m128i v = _mm_or_si128(t1, t3);  // one 6-bit value per byte
+  // classify each value into the alphabet ranges 0-9, a-z, A-Z, '+', '/'
+  // then shuffle in the character offset of its range
+  __m128i idx = _mm_setzero_si128();
+  idx = _mm_sub_epi8(idx, _mm_cmpgt_epi8(v, _mm_set1_epi8(9)));
+  idx = _mm_sub_epi8(idx, _mm_cmpgt_epi8(v, _mm_set1_epi8(35)));
+  idx = _mm_sub_epi8(idx, _mm_cmpgt_epi8(v, _mm_set1_epi8(61)));
+  idx = _mm_sub_epi8(idx, _mm_cmpgt_epi8(v, _mm_set1_epi8(62)));
+  const __m128i off = _mm_setr_epi8('0', 'a' - 10, 'A' - 36, '+' - 62,
+                                    '/' - 63, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  _mm_storeu_si128((__m128i *)out,
+                   _mm_add_epi8(v, _mm_shuffle_epi8(off, idx)));
+}
+
+// decode 16 base64 characters into 12 bytes of out
+// Returns 0 if any character is not valid base64
+static int base64_decode_block(const char *in, uint8_t *out) {
+  const __m128i c = _mm_loadu_si128((const __m128i *)in);
+  const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+  const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), c));
+  const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)),
+                                      _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), c));
+  const __m128i plus = _mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+  const __m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+  const __m128i valid = _mm_or_si128(
+      _mm_or_si128(_mm_or_si128(digit, lower), _mm_or_si128(upper, slash)),
+      plus);
+  if (_mm_movemask_epi8(valid) != 0xFFFF) return 0;
+  // character minus range offset recovers the 6-bit value
+  __m128i delta = _mm_and_si128(digit, _mm_set1_epi8(-'0'));
+  delta = _mm_or_si128(delta, _mm_and_si128(lower, _mm_set1_epi8(10 - 'a')));
+  delta = _mm_or_si128(delta, _mm_and_si128(upper, _mm_set1_epi8(36 - 'A')));
+  delta = _mm_or_si128(delta, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+  delta = _mm_or_si128(delta, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+  const __m128i v = _mm_add_epi8(c, delta);
+  // pack the four 6-bit values of each group back into 3 bytes
+  const __m128i ab = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+  const __m128i abc = _mm_madd_epi16(ab, _mm_set1_epi32(0x00011000));
+  const __m128i r = _mm_shuffle_epi8(
+      abc, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1,
+                         -1));
+  _mm_storel_epi64((__m128i *)out, r);
+  const uint32_t w = _mm_cvtsi128_si32(_mm_srli_si128(r, 8));
+  memcpy(out + 8, &w, 4);
+  return 1;
+}
+
+// shuffle in characters from a 32 entry alphabet held in two registers,
+// idx values must be 0-31
+static __m128i lookup32(const __m128i lo, const __m128i hi, const __m128i idx) {
+  const __m128i is_hi = _mm_cmpgt_epi8(idx, _mm_set1_epi8(15));
+  const __m128i i15 = _mm_and_si128(idx, _mm_set1_epi8(15));
+  return _mm_or_si128(_mm_andnot_si128(is_hi, _mm_shuffle_epi8(lo, i15)),
+                      _mm_and_si128(is_hi, _mm_shuffle_epi8(hi, i15)));
+}
+
+// encode 10 bytes of in as 16 zbase32 characters, reads 16 bytes of in
+static void zbase32_encode_block(const uint8_t *in, char *out) {
+  const __m128i data = _mm_loadu_si128((const __m128i *)in);
+  // 16-bit windows covering each 5-bit field of the two 40-bit groups, then
+  // shift each window down by a per-lane constant via the high multiply
+  const __m128i mul =
+      _mm_setr_epi16(32, 1024, 128, 4096, 512, 64, 2048, 256);
+  const __m128i wa = _mm_shuffle_epi8(
+      data, _mm_setr_epi8(1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3, 5, 4));
+  const __m128i wb = _mm_shuffle_epi8(
+      data, _mm_setr_epi8(6, 5, 6, 5, 7, 6, 7, 6, 8, 7, 9, 8, 9, 8, 10, 9));
+  const __m128i mask = _mm_set1_epi16(31);
+  const __m128i va = _mm_and_si128(_mm_mulhi_epu16(wa, mul), mask);
+  const __m128i vb = _mm_and_si128(_mm_mulhi_epu16(wb, mul), mask);
+  const __m128i idx = _mm_packus_epi16(va, vb);
+  const __m128i lo = _mm_loadu_si128((const __m128i *)zbase32);
+  const __m128i hi = _mm_loadu_si128((const __m128i *)(zbase32 + 16));
+  _mm_storeu_si128((__m128i *)out, lookup32(lo, hi, idx));
+}
+
+// translate 16 zbase32 characters into their 5-bit values
+// Returns 0 if any character is not valid zbase32
+static int zbase32_decode_block(const char *in, uint8_t *v16) {
+  const __m128i c = _mm_loadu_si128((const __m128i *)in);
+  const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), c));
+  const __m128i letter = _mm_and_si128(
+      _mm_cmpgt_epi8(c, _mm_set1_epi8('a' - 1)),
+      _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), c));
+  // value of each digit and letter, -1 marks characters outside the alphabet
+  const __m128i dtab = _mm_setr_epi8(-1, 18, -1, 25, 26, 27, 30, 29, 7, 31, -1,
+                                     -1, -1, -1, -1, -1);
+  const __m128i ltab_lo = _mm_setr_epi8(24, 1, 12, 3, 8, 5, 6, 28, 21, 9, 10,
+                                        -1, 11, 2, 16, 13);
+  const __m128i ltab_hi = _mm_setr_epi8(14, 4, 22, 17, 19, -1, 20, 15, 0, 23,
+                                        -1, -1, -1, -1, -1, -1);
+  const __m128i dval = _mm_shuffle_epi8(
+      dtab, _mm_and_si128(_mm_sub_epi8(c, _mm_set1_epi8('0')), digit));
+  const __m128i lval = lookup32(
+      ltab_lo, ltab_hi,
+      _mm_and_si128(_mm_sub_epi8(c, _mm_set1_epi8('a')), letter));
+  __m128i v = _mm_and_si128(dval, digit);
+  v = _mm_or_si128(v, _mm_and_si128(lval, letter));
+  v = _mm_or_si128(
+      v, _mm_andnot_si128(_mm_or_si128(digit, letter), _mm_set1_epi8(-1)));
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(-1)))) return 0;
+  _mm_storeu_si128((__m128i *)v16, v);
+  return 1;
+}
+
+// pack eight 5-bit values into 5 bytes
+static void zbase32_pack8(const uint8_t *c, uint8_t *b) {
+  b[0] = c[0] << 3 | c[1] >> 2;
+  b[1] = c[1] << 6 | c[2] << 1 | c[3] >> 4;
+  b[2] = c[3] << 4 | c[4] >> 1;
+  b[3] = c[4] << 7 | c[5] << 2 | c[6] >> 3;
+  b[4] = c[6] << 5 | c[7];
+}
+
+#endif
+
+int myriota_n_base64_to_buf(const char *s, const size_t n, void *buf) {
+  if (n % 4 != 0) return -1;  // only multiples of 4 supported
+  size_t nchars = n;
+  uint8_t *b = (uint8_t *)buf;
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SSSE3__)
+  while (nchars >= 16) {
+    // on an invalid character fall through, the scalar code reports it
+    if (!base64_decode_block(s, b)) break;
+    s += 16;
+    b += 12;
+    nchars -= 16;
+  }
+#endif
+  if (base64_decode_scalar(s, nchars, b) < 0) return -1;
+  return n;
+}
+
+int myriota_base64_to_buf(const char *s, void *buf) {
+  return myriota_n_base64_to_buf(s, strlen(s), buf);
+}
+
+int myriota_buf_to_base64(const void *buf, const size_t buf_size, char *s) {
+  if (buf_size % 3 != 0) return -1;  // only multiples of 3 supported
+  size_t nbytes = buf_size;
+  const uint8_t *p = (const uint8_t *)buf;
+  int count = 0;
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SSSE3__)
+  while (nbytes >= 16) {  // 16-byte loads must stay within buf
+    base64_encode_block(p, s + count);
+    p += 12;
+    nbytes -= 12;
+    count += 16;
+  }
+#endif
+  count += base64_encode_scalar(p, nbytes, s + count);
+  s[count] = '\0';
+  return count;
+}
+
 // converts integer in the range 0 - 31 to a base32 character.
 // Return -1 if n is out of range
 char myriota_number_to_zbase32(int n) {
@@ -247,10 +686,20 @@ int myriota_zbase32_to_number(char b) {
 
 int myriota_buf_to_zbase32(const void *buf, const size_t buf_size, char *s) {
   if (buf_size % 5 != 0) return -1;  // only multiples of 5 supported
+  size_t nbytes = buf_size;
+  const uint8_t *p = (const uint8_t *)buf;
   uint8_t n = 0;
   int count = 0;
-  for (unsigned int i = 0; i < buf_size * 8; i++) {
-    const int bit = myriota_get_bit(i, buf);
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SSSE3__)
+  while (nbytes >= 16) {  // 16-byte loads must stay within buf
+    zbase32_encode_block(p, s + count);
+    p += 10;
+    nbytes -= 10;
+    count += 16;
+  }
+#endif
+  for (unsigned int i = 0; i < nbytes * 8; i++) {
+    const int bit = myriota_get_bit(i, p);
     myriota_set_bit((i % 5) + 3, bit, &n);
     if ((i % 5) == 4) {
       s[count] = myriota_number_to_zbase32(n);
@@ -263,12 +712,26 @@ int myriota_buf_to_zbase32(const void *buf, const size_t buf_size, char *s) {
 }
 
 int myriota_n_zbase32_to_buf(const char *s, const size_t n, void *buf) {
-  for (unsigned int i = 0; i < n * 5; i++) {
-    const int b = myriota_zbase32_to_number(s[i / 5]);
-    if (b < 0) return -1;
-    const uint8_t c = b;
+  size_t nchars = n;
+  uint8_t *b = (uint8_t *)buf;
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SSSE3__)
+  while (nchars >= 16) {
+    uint8_t v[16];
+    // on an invalid character fall through, the scalar code reports it
+    if (!zbase32_decode_block(s, v)) break;
+    zbase32_pack8(v, b);
+    zbase32_pack8(v + 8, b + 5);
+    s += 16;
+    b += 10;
+    nchars -= 16;
+  }
+#endif
+  for (unsigned int i = 0; i < nchars * 5; i++) {
+    const int x = myriota_zbase32_to_number(s[i / 5]);
+    if (x < 0) return -1;
+    const uint8_t c = x;
     const int bit = myriota_get_bit((i % 5) + 3, &c);
-    myriota_set_bit(i, bit, buf);
+    myriota_set_bit(i, bit, b);
   }
   return n;
 }
@@ -277,34 +740,121 @@ int myriota_zbase32_to_buf(const char *s, void *buf) {
   return myriota_n_zbase32_to_buf(s, strlen(s), buf);
 }
 
-int myriota_random_bernoulli(double p) {
-  double r = myriota_random_uniform();
-  if (r < p) return 1;
-  return 0;
+// xoshiro256++ by Blackman and Vigna, public domain reference implementation
+// from prng.di.unimi.it. State is seeded through splitmix64 so that any
+// seed, including zero, yields a well mixed nonzero state.
+
+static uint64_t rotl64(const uint64_t x, const int k) {
+  return (x << k) | (x >> (64 - k));
 }
 
-int myriota_random_geometric(double p) {
+void myriota_rng_init(myriota_rng *rng, uint64_t seed) {
+  for (int i = 0; i < 4; i++) {
+    seed += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = seed;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    rng->s[i] = z ^ (z >> 31);
+  }
+}
+
+uint64_t myriota_rng_next(myriota_rng *rng) {
+  uint64_t *s = rng->s;
+  const uint64_t result = rotl64(s[0] + s[3], 23) + s[0];
+  const uint64_t t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl64(s[3], 45);
+  return result;
+}
+
+void myriota_rng_jump(myriota_rng *rng) {
+  static const uint64_t JUMP[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+                                  0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+  uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  for (unsigned int i = 0; i < NUM_ELEMS(JUMP); i++)
+    for (int b = 0; b < 64; b++) {
+      if (JUMP[i] & 1ULL << b) {
+        s0 ^= rng->s[0];
+        s1 ^= rng->s[1];
+        s2 ^= rng->s[2];
+        s3 ^= rng->s[3];
+      }
+      myriota_rng_next(rng);
+    }
+  rng->s[0] = s0;
+  rng->s[1] = s1;
+  rng->s[2] = s2;
+  rng->s[3] = s3;
+}
+
+double myriota_rng_uniform(myriota_rng *rng) {
+  // 53 bit mantissa, uniform on [0,1)
+  return (myriota_rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int myriota_rng_bernoulli(myriota_rng *rng, double p) {
+  return myriota_rng_uniform(rng) < p;
+}
+
+int myriota_rng_geometric(myriota_rng *rng, double p) {
   assert(p > 0.0);  // p == 0.0 will run forever
   int i = 1;
-  while (!myriota_random_bernoulli(p)) i++;
+  while (!myriota_rng_bernoulli(rng, p)) i++;
   return i;
 }
 
-// Generate a normally distributed random variable.
 // Uses the Box Muller method
-double myriota_random_normal() {
+double myriota_rng_normal(myriota_rng *rng) {
   const double eps = 1e-15;
-  double u = myriota_random_uniform();
-  double v = myriota_random_uniform();
-  while (u < eps) u = myriota_random_uniform();
+  double u = myriota_rng_uniform(rng);
+  double v = myriota_rng_uniform(rng);
+  while (u < eps) u = myriota_rng_uniform(rng);
   return sqrt(-2 * log(u)) * cos(2 * pi * v);
 }
 
-double myriota_random_exponential(const double mean) {
-  const double u = myriota_random_uniform();
+double myriota_rng_exponential(myriota_rng *rng, const double mean) {
+  // uniform on (0,1] so the logarithm is finite
+  const double u = ((myriota_rng_next(rng) >> 11) + 1) *
+                   (1.0 / 9007199254740992.0);
   return -log(u) * mean;
 }
 
+int myriota_rng_discrete(myriota_rng *rng, const double *p, int n) {
+  return myriota_random_discrete(p, n, myriota_rng_uniform(rng));
+}
+
+myriota_rng *myriota_rng_default(void) {
+  static myriota_rng rng;
+  static bool seeded = false;
+  if (!seeded) {
+    myriota_rng_init(&rng, 0);
+    seeded = true;
+  }
+  return &rng;
+}
+
+int myriota_random_bernoulli(double p) {
+  return myriota_rng_bernoulli(myriota_rng_default(), p);
+}
+
+int myriota_random_geometric(double p) {
+  return myriota_rng_geometric(myriota_rng_default(), p);
+}
+
+// Generate a normally distributed random variable.
+// Uses the Box Muller method
+double myriota_random_normal() {
+  return myriota_rng_normal(myriota_rng_default());
+}
+
+double myriota_random_exponential(const double mean) {
+  return myriota_rng_exponential(myriota_rng_default(), mean);
+}
+
 int myriota_random_discrete(const double *p, int n, double u) {
   double sum = 0.0;
   for (int i = 0; i < n; i++) sum += p[i];
@@ -428,6 +978,142 @@ double myriota_minimise(double (*f)(double, void *), void *fdata,
   return myriota_minimise(f, fdata, a, bt, tol);
 }
 
+double myriota_brent_root(double (*f)(double, void *), void *fdata,
+                          const double ax, const double bx, const double tol,
+                          const int max_evals) {
+  double a = ax, b = bx;
+  double fa = f(a, fdata), fb = f(b, fdata);
+  int evals = 2;
+  if (fa == 0) return a;
+  double c = a, fc = fa;
+  double d = b - a, e = d;
+  while (1) {
+    // keep b the best estimate, c on the opposite side of the root
+    if (fabs(fc) < fabs(fb)) {
+      a = b;
+      b = c;
+      c = a;
+      fa = fb;
+      fb = fc;
+      fc = fa;
+    }
+    const double tol1 = 2 * DBL_EPSILON * fabs(b) + tol / 2;
+    const double xm = (c - b) / 2;
+    if (fabs(xm) <= tol1 || fb == 0 || evals >= max_evals) return b;
+    if (fabs(e) >= tol1 && fabs(fa) > fabs(fb)) {
+      // attempt interpolation, secant if only two points are distinct,
+      // otherwise inverse quadratic through (a,fa), (b,fb), (c,fc)
+      const double s = fb / fa;
+      double p, q;
+      if (a == c) {
+        p = 2 * xm * s;
+        q = 1 - s;
+      } else {
+        const double t = fa / fc, r = fb / fc;
+        p = s * (2 * xm * t * (t - r) - (b - a) * (r - 1));
+        q = (t - 1) * (r - 1) * (s - 1);
+      }
+      if (p > 0) q = -q;
+      p = fabs(p);
+      // accept only if the step stays in the bracket and shrinks fast
+      // enough, otherwise fall back to bisection
+      if (2 * p < fmin(3 * xm * q - fabs(tol1 * q), fabs(e * q))) {
+        e = d;
+        d = p / q;
+      } else {
+        d = xm;
+        e = d;
+      }
+    } else {
+      d = xm;
+      e = d;
+    }
+    a = b;
+    fa = fb;
+    if (fabs(d) > tol1)
+      b += d;
+    else
+      b += xm > 0 ? tol1 : -tol1;
+    fb = f(b, fdata);
+    evals++;
+    if ((fb > 0) == (fc > 0)) {
+      c = a;
+      fc = fa;
+      d = b - a;
+      e = d;
+    }
+  }
+}
+
+double myriota_brent_minimise(double (*f)(double, void *), void *fdata,
+                              const double ax, const double bx,
+                              const double tol, const int max_evals) {
+  const double cg = 0.3819660112501051;  // 2 minus the golden ratio
+  double a = fmin(ax, bx), b = fmax(ax, bx);
+  double x = a + cg * (b - a), w = x, v = x;
+  double fx = f(x, fdata), fw = fx, fv = fx;
+  double d = 0, e = 0;
+  int evals = 1;
+  while (1) {
+    const double xm = (a + b) / 2;
+    const double tol1 = DBL_EPSILON * fabs(x) + tol / 3;
+    const double tol2 = 2 * tol1;
+    if (fabs(x - xm) <= tol2 - (b - a) / 2 || evals >= max_evals) return x;
+    int golden = 1;
+    if (fabs(e) > tol1) {
+      // parabola through (v,fv), (w,fw), (x,fx)
+      const double r = (x - w) * (fx - fv);
+      double q = (x - v) * (fx - fw);
+      double p = (x - v) * q - (x - w) * r;
+      q = 2 * (q - r);
+      if (q > 0) p = -p;
+      q = fabs(q);
+      const double elast = e;
+      e = d;
+      // accept only if the step is shrinking and lands inside (a, b)
+      if (fabs(p) < fabs(q * elast / 2) && p > q * (a - x) && p < q * (b - x)) {
+        d = p / q;
+        const double u = x + d;
+        if (u - a < tol2 || b - u < tol2) d = xm > x ? tol1 : -tol1;
+        golden = 0;
+      }
+    }
+    if (golden) {
+      e = x >= xm ? a - x : b - x;
+      d = cg * e;
+    }
+    const double u = fabs(d) >= tol1 ? x + d : x + (d > 0 ? tol1 : -tol1);
+    const double fu = f(u, fdata);
+    evals++;
+    if (fu <= fx) {
+      if (u >= x)
+        a = x;
+      else
+        b = x;
+      v = w;
+      w = x;
+      x = u;
+      fv = fw;
+      fw = fx;
+      fx = fu;
+    } else {
+      if (u < x)
+        a = u;
+      else
+        b = u;
+      if (fu <= fw || w == x) {
+        v = w;
+        w = u;
+        fv = fw;
+        fw = fu;
+      } else if (fu <= fv || v == x || v == w) {
+        v = u;
+        fv = fu;
+      }
+    }
+  }
+}
+
 // integrate the function f from a to infinity using the substitution x = a +
 // (t/(1-t))
 double myriota_integrate_infty(double (*f)(double, void *), void *fdata,
@@ -451,6 +1137,32 @@ double myriota_unwrap(const double value, const double previous_value) {
   return d + previous_value;
 }
 
+void myriota_unwrap_array(const double *in, double *out, const size_t n) {
+  if (n == 0) return;
+  double prev = in[0];
+  out[0] = myriota_unwrap(in[0], 0);
+  // wrapped first differences, each element independent of the output so
+  // this loop vectorises
+  for (size_t k = 1; k < n; k++) {
+    double d = myriota_fracpart_scaled(in[k] - prev, 2 * pi);
+    prev = in[k];
+    if (d > pi) d -= 2 * pi;
+    if (d < -pi) d += 2 * pi;
+    out[k] = d;
+  }
+  for (size_t k = 1; k < n; k++) out[k] += out[k - 1];
+}
+
+void myriota_unwrap_array_32(const int32_t *in, int64_t *out, const size_t n) {
+  if (n == 0) return;
+  out[0] = in[0];
+  // two's complement subtraction yields the difference wrapped into
+  // [-2^31, 2^31), i.e. the nearest representative of the phase step
+  for (size_t k = 1; k < n; k++)
+    out[k] = (int32_t)((uint32_t)in[k] - (uint32_t)in[k - 1]);
+  for (size_t k = 1; k < n; k++) out[k] += out[k - 1];
+}
+
 // hidden reverse function used by myriota_rotate
 // This implementaiton is based on John Bentley's
 // Pearls of Programing refered to at:
@@ -510,6 +1222,62 @@ void myriota_msequence(const int N, int *r) {
   }
 }
 
+// reverse the bits of a byte, e.g. 0x01 -> 0x80
+static uint8_t reverse_byte(uint8_t b) {
+  b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+  b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+  return (b & 0xAA) >> 1 | (b & 0x55) << 1;
+}
+
+void myriota_msequence_bits(const int N, uint8_t *r) {
+  // Feedback distance masks, bit d-1 set when output bit y[t-d] feeds y[t].
+  // Entries for N <= 14 are the generator polynomials of myriota_msequence so
+  // the two functions emit identical sequences; longer entries are maximal
+  // length taps from the standard tables.
+  static const uint32_t D[25] = {
+      0,        0,        0,       0x6,     0xC,      0x14,    0x30,
+      0x48,     0xB8,     0x110,   0x240,   0x500,    0xCA0,   0x1B00,
+      0x3088,   0x6000,   0xD008,  0x12000, 0x20400,  0x40023, 0x90000,
+      0x140000, 0x300000, 0x420000, 0xE10000};
+  if (N < 3 || N > 24)
+    error_message_and_exit(
+        "Only m-sequences with N > 2 and N < 25 are available.");
+  const uint32_t d = D[N];
+  int dmin = 1;
+  while (!(d >> (dmin - 1) & 1)) dmin++;
+  const uint32_t M = (1u << N) - 1;
+  // h bit j holds output bit y[t-N+j]. The first N outputs are the N-1 ones
+  // of the all ones initial state followed by its feedback, which is zero as
+  // the polynomials have an even number of taps
+  uint64_t h = (1ull << (N - 1)) - 1;
+  // emitted bits are packed chronologically into acc, oldest at bit zero,
+  // and flushed a byte at a time, bit reversed so the oldest bit lands in
+  // the most significant position as myriota_get_bit expects
+  uint64_t acc = h;
+  int nacc = N;
+  uint32_t t = N;
+  while (1) {
+    while (nacc >= 8) {
+      *r++ = reverse_byte(acc & 0xFF);
+      acc >>= 8;
+      nacc -= 8;
+    }
+    if (t >= M) break;
+    // one XOR of shifted words per tap extends the sequence by b bits
+    uint32_t b = (uint32_t)dmin < 64u - N ? (uint32_t)dmin : 64u - N;
+    if (b > M - t) b = M - t;
+    uint64_t nw = 0;
+    for (int j = 0; j < N; j++)
+      if (d >> j & 1) nw ^= h >> (N - 1 - j);
+    nw &= (1ull << b) - 1;
+    h = h >> b | nw << (N - b);
+    acc |= nw << nacc;
+    nacc += b;
+    t += b;
+  }
+  if (nacc > 0) *r = reverse_byte(acc & 0xFF);
+}
+
 int myriota_sort_unique(void *base, size_t nitems, size_t size,
                         int (*cmp)(const void *, const void *)) {
   if (base == NULL) return 0;
@@ -13,30 +13,295 @@
 
 #include "math/myriotamath.h"
 
+#include <unistd.h>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#if !defined(MYRIOTA_MATH_NO_SIMD) && (defined(__AVX__) || defined(__SSE2__))
+#include <immintrin.h>
+#endif
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__ARM_NEON) && \
+    defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace myriota {
 
 static double h(double t, double W) {
   return myriota_sinc(t) * myriota_blackman(t, W);
 }
 
+// Dot product of complex samples with real taps, the hot loop of the
+// resampler. Accumulation starts from acc so a sum split across the circular
+// buffer boundary proceeds in the same order as a single pass. The SIMD
+// variant is selected by the instruction sets enabled at build time, see
+// MATH_SIMD in math/build.mk for the scalar fallback.
+#if !defined(MYRIOTA_MATH_NO_SIMD) && defined(__AVX__)
+static complex resample_dot(const complex *x, const double *t, const size_t n,
+                            const complex acc) {
+  __m256d sum4 = _mm256_setzero_pd();
+  size_t k = 0;
+  for (; k + 2 <= n; k += 2) {
+    const __m256d s = _mm256_loadu_pd((const double *)(x + k));
+    const __m256d tap = _mm256_setr_pd(t[k], t[k], t[k + 1], t[k + 1]);
+    sum4 = _mm256_add_pd(sum4, _mm256_mul_pd(s, tap));
+  }
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(sum4),
+                           _mm256_extractf128_pd(sum4, 1));
+  sum = _mm_add_pd(sum, _mm_loadu_pd((const double *)&acc));
+  if (k < n) {
+    const __m128d s = _mm_loadu_pd((const double *)(x + k));
+    sum = _mm_add_pd(sum, _mm_mul_pd(s, _mm_set1_pd(t[k])));
+  }
+  double out[2];
+  _mm_storeu_pd(out, sum);
+  return complex(out[0], out[1]);
+}
+#elif !defined(MYRIOTA_MATH_NO_SIMD) && defined(__SSE2__)
+static complex resample_dot(const complex *x, const double *t, const size_t n,
+                            const complex acc) {
+  // one complex per step, real and imaginary parts in separate lanes
+  __m128d sum = _mm_loadu_pd((const double *)&acc);
+  for (size_t k = 0; k < n; k++) {
+    const __m128d s = _mm_loadu_pd((const double *)(x + k));
+    sum = _mm_add_pd(sum, _mm_mul_pd(s, _mm_set1_pd(t[k])));
+  }
+  double out[2];
+  _mm_storeu_pd(out, sum);
+  return complex(out[0], out[1]);
+}
+#elif !defined(MYRIOTA_MATH_NO_SIMD) && defined(__ARM_NEON) && \
+    defined(__aarch64__)
+static complex resample_dot(const complex *x, const double *t, const size_t n,
+                            const complex acc) {
+  float64x2_t sum = vld1q_f64((const double *)&acc);
+  for (size_t k = 0; k < n; k++)
+    sum = vfmaq_n_f64(sum, vld1q_f64((const double *)(x + k)), t[k]);
+  double out[2];
+  vst1q_f64(out, sum);
+  return complex(out[0], out[1]);
+}
+#else
+static complex resample_dot(const complex *x, const double *t, const size_t n,
+                            const complex acc) {
+  complex sum = acc;
+  for (size_t k = 0; k < n; k++) sum += x[k] * t[k];
+  return sum;
+}
+#endif
+
+// Reorganise filter taps into r.p zero padded rows of contiguous per phase
+// (polyphase) taps. Tap(t) with t = phase + k*r.p pairs with input sample
+// m = (r.q*n - t)/r.p of output sample n where phase = mod(r.q*n, r.p). Rows
+// are ordered by ascending input index m. Returns the common row length.
+template <typename T, typename F>
+static size_t polyphase_rows(const myriota_rational r, const int gmin,
+                             const int gmax, F tap, std::vector<T> &rows) {
+  const size_t len = (gmax - gmin) / r.p + 1;
+  rows.assign(r.p * len, 0);
+  for (int64_t phase = 0; phase < r.p; phase++) {
+    const int64_t tmax = gmax - mod<int64_t>(gmax - phase, r.p);
+    for (size_t j = 0; j < len && tmax - (int64_t)j * r.p >= gmin; j++)
+      rows[phase * len + j] = tap(tmax - j * r.p);
+  }
+  return len;
+}
+
+// Process-wide caches of immutable tap sets keyed by the rational resampling
+// ratio and window width, so many resampler instances of the same
+// configuration share one tap computation and one copy of the taps. Entries
+// are retained for the life of the process, bounded by the number of distinct
+// configurations constructed.
+std::shared_ptr<const ResampleTaps> resample_taps(const myriota_rational r,
+                                                  const double W) {
+  typedef std::tuple<long long, long long, double> Key;
+  static std::mutex mutex;
+  static std::map<Key, std::shared_ptr<const ResampleTaps>> cache;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<const ResampleTaps> &entry = cache[Key(r.p, r.q, W)];
+  if (!entry) {
+    const int xi = r.p > r.q ? r.p : r.q;
+    const int gmin = ceil(-xi * W);
+    const int gmax = floor(xi * W);
+    auto t = std::make_shared<ResampleTaps>();
+    for (int n = gmin; n <= gmax; n++) t->g.push_back(h((1.0 * n) / xi, W));
+    const std::vector<double> &g = t->g;
+    t->row_len = polyphase_rows(
+        r, gmin, gmax, [&g, gmin](int64_t n) { return g[n - gmin]; }, t->rows);
+    entry = t;
+  }
+  return entry;
+}
+
+// the 16-bit cache is shared with the file backed variant below so both
+// live at file scope rather than as function statics
+typedef std::tuple<long long, long long, double> TapsKey;
+static std::mutex taps_16_mutex;
+static std::map<TapsKey, std::shared_ptr<const ResampleTaps16>> taps_16_cache;
+
+static std::shared_ptr<const ResampleTaps16> compute_taps_16(
+    const myriota_rational r, const double W) {
+  const int xi = r.p > r.q ? r.p : r.q;
+  const int gmin = ceil(-xi * W);
+  const int gmax = floor(xi * W);
+  const double gamma = (1.0 * r.p) / r.q;
+  const double kappa = fmin(1, gamma);
+  // fixed point scaling parameter, see Resample16::beta
+  double b = 0;
+  for (int n = 0; n < r.p; n++) {
+    const double ng = n / gamma;
+    const double Wk = W / kappa;
+    const int64_t U = floor(ng + Wk);
+    const int64_t L = ceil(ng - Wk);
+    double gsum = 0;
+    for (int64_t l = L; l <= U; l++)
+      gsum += fabs(h((1.0 * (r.q * n - r.p * l)) / xi, W));
+    if (gsum > b) b = gsum;
+  }
+  auto t = std::make_shared<ResampleTaps16>();
+  t->alpha = floor((1 << 16) / (kappa * b));
+  for (int n = gmin; n <= gmax; n++)
+    t->f.push_back(floor(kappa * t->alpha * h((1.0 * n) / xi, W)));
+  const std::vector<int32_t> &f = t->f;
+  t->row_len = polyphase_rows(
+      r, gmin, gmax, [&f, gmin](int64_t n) { return f[n - gmin]; }, t->rows);
+  return t;
+}
+
+std::shared_ptr<const ResampleTaps16> resample_taps_16(const myriota_rational r,
+                                                       const double W) {
+  std::lock_guard<std::mutex> lock(taps_16_mutex);
+  std::shared_ptr<const ResampleTaps16> &entry =
+      taps_16_cache[TapsKey(r.p, r.q, W)];
+  if (!entry) entry = compute_taps_16(r, W);
+  return entry;
+}
+
+// the tap file is the header below followed by the f and rows arrays, all
+// native endian; the parameters are repeated inside the file so a stale or
+// misnamed file is detected and recomputed rather than trusted
+struct TapsFileHeader {
+  char magic[8];
+  uint32_t version;
+  int64_t p, q;
+  double W;
+  int32_t alpha;
+  uint64_t nf, nrows, row_len;
+};
+static const char taps_file_magic[8] = {'R', '1', '6', 'T', 'A', 'P', 'S', 0};
+
+static std::shared_ptr<const ResampleTaps16> load_taps_16(const char *path,
+                                                          const myriota_rational r,
+                                                          const double W) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) return NULL;
+  TapsFileHeader hdr;
+  auto t = std::make_shared<ResampleTaps16>();
+  bool ok = fread(&hdr, sizeof(hdr), 1, file) == 1 &&
+            memcmp(hdr.magic, taps_file_magic, 8) == 0 && hdr.version == 1 &&
+            hdr.p == r.p && hdr.q == r.q && hdr.W == W &&
+            hdr.nrows == (uint64_t)r.p * hdr.row_len &&
+            hdr.nf <= hdr.nrows && hdr.nf > 0;
+  if (ok) {
+    t->alpha = hdr.alpha;
+    t->row_len = hdr.row_len;
+    t->f.resize(hdr.nf);
+    t->rows.resize(hdr.nrows);
+    ok = fread(t->f.data(), sizeof(int32_t), hdr.nf, file) == hdr.nf &&
+         fread(t->rows.data(), sizeof(int32_t), hdr.nrows, file) == hdr.nrows;
+  }
+  fclose(file);
+  return ok ? t : NULL;
+}
+
+static void store_taps_16(const char *path, const myriota_rational r,
+                          const double W, const ResampleTaps16 &t) {
+  // write to a temporary and rename so concurrent invocations, e.g. batch
+  // scripts starting many resamplers at once, never observe a partial file
+  char tmp[1024];
+  if (snprintf(tmp, sizeof(tmp), "%s.%d.tmp", path, (int)getpid()) >=
+      (int)sizeof(tmp))
+    return;
+  FILE *file = fopen(tmp, "wb");
+  if (file == NULL) return;
+  TapsFileHeader hdr = {};
+  memcpy(hdr.magic, taps_file_magic, 8);
+  hdr.version = 1;
+  hdr.p = r.p;
+  hdr.q = r.q;
+  hdr.W = W;
+  hdr.alpha = t.alpha;
+  hdr.nf = t.f.size();
+  hdr.nrows = t.rows.size();
+  hdr.row_len = t.row_len;
+  const bool ok =
+      fwrite(&hdr, sizeof(hdr), 1, file) == 1 &&
+      fwrite(t.f.data(), sizeof(int32_t), t.f.size(), file) == t.f.size() &&
+      fwrite(t.rows.data(), sizeof(int32_t), t.rows.size(), file) ==
+          t.rows.size();
+  if (fclose(file) != 0 || !ok || rename(tmp, path) != 0) remove(tmp);
+}
+
+std::shared_ptr<const ResampleTaps16> resample_taps_16_file(
+    const myriota_rational r, const double W, const char *dir) {
+  char path[1024];
+  if (snprintf(path, sizeof(path), "%s/resample16_%lld_%lld_%.17g.taps", dir,
+               r.p, r.q, W) >= (int)sizeof(path))
+    return resample_taps_16(r, W);
+  std::lock_guard<std::mutex> lock(taps_16_mutex);
+  std::shared_ptr<const ResampleTaps16> &entry =
+      taps_16_cache[TapsKey(r.p, r.q, W)];
+  if (entry) return entry;
+  entry = load_taps_16(path, r, W);
+  if (!entry) {
+    entry = compute_taps_16(r, W);
+    store_taps_16(path, r, W, *entry);
+  }
+  return entry;
+}
+
 ResampleDouble::ResampleDouble(double in_rate, double out_rate, double W)
     : Resample<complex>(in_rate, out_rate, W, 0.0) {
-  for (int n = gmin; n <= gmax; n++) {
-    const double t = (1.0 * n) / xi;
-    g_buf.push_back(h(t, W));
-  }
+  taps_ = resample_taps(r, this->W);
 }
 
 complex ResampleDouble::operator()(int64_t n) const {
-  const double ng = n / gamma;
-  const double Wk = W / kappa;
-  const int64_t L = ceil(ng - Wk);
-  const int64_t U = floor(ng + Wk);
-  complex sum = 0;
-  for (int64_t m = L; m <= U; m++) sum += a(m) * g(r.q * n - r.p * m);
+  // the row of phase mod(r.q*n, r.p) covers exactly the taps with
+  // |r.q*n - r.p*m| <= xi*W, i.e. the window ceil(ng-Wk) <= m <= floor(ng+Wk)
+  // of the direct form, plus zero padding
+  const int64_t qn = r.q * n;
+  const int64_t phase = mod<int64_t>(qn, r.p);
+  const int64_t m0 = (qn - (gmax - mod<int64_t>(gmax - phase, r.p))) / r.p;
+  const size_t p_len = taps_->row_len;
+  const double *taps = &taps_->rows[phase * p_len];
+  const size_t i0 = m0 & a.mask;
+  const size_t n1 = p_len < a.size - i0 ? p_len : a.size - i0;
+  complex sum = resample_dot(a.data() + i0, taps, n1, 0.0);
+  if (n1 < p_len) sum = resample_dot(a.data(), taps + n1, p_len - n1, sum);
   return kappa * sum;
 }
 
+// Shared engine for the non-virtual block APIs. R is the concrete resampler
+// class so the qualified operator() call binds statically.
+template <typename R, typename T>
+static size_t process_block(R &r, int64_t &next, const T *in, size_t nin,
+                            T *out, size_t nout_max) {
+  size_t used = 0, produced = 0;
+  while (produced < nout_max) {
+    while (r.maxn() < next && used < nin) r.push(in[used++]);
+    if (r.maxn() < next) break;  // in exhausted
+    out[produced++] = r.R::operator()(next);
+    next++;
+  }
+  return produced;
+}
+
+size_t ResampleDouble::process(const complex *in, size_t nin, complex *out,
+                               size_t nout_max) {
+  return process_block(*this, n_next, in, nin, out, nout_max);
+}
+
 double Resample16::g(int64_t n) const { return h((1.0 * n) / xi, W); }
 
 double Resample16::beta() const {
@@ -56,24 +321,21 @@ double Resample16::beta() const {
 Resample16::Resample16(double in_rate, double out_rate, double W)
     : Resample<myriota_complex_16>(in_rate, out_rate, W,
                                    (myriota_complex_16){0, 0}),
-      alpha(floor((1 << 16) / beta())) {
-  for (int n = gmin; n <= gmax; n++)
-    f_buf.push_back(floor(kappa * alpha * g(n)));
+      alpha(resample_taps_16(r, this->W)->alpha) {
+  taps_ = resample_taps_16(r, this->W);  // second lookup hits the cache
 }
 
 myriota_complex_32 Resample16::n32(int64_t n) const {
-  const double ng = n / gamma;
-  const double Wk = W / kappa;
-  const int64_t U = floor(ng + Wk);
-  const int64_t L = ceil(ng - Wk);
+  const int64_t qn = r.q * n;
+  const int64_t phase = mod<int64_t>(qn, r.p);
+  const int64_t m0 = (qn - (gmax - mod<int64_t>(gmax - phase, r.p))) / r.p;
+  const size_t p_len = taps_->row_len;
+  const int32_t *taps = &taps_->rows[phase * p_len];
   int32_t re = 0, im = 0;
-  int64_t pm = r.q * n - r.p * L;
-  for (int64_t m = L; m <= U; m++) {
-    const int32_t fv = f(pm);
-    pm -= r.p;
-    const myriota_complex_16 am = a(m);
-    re += am.re * fv;
-    im += am.im * fv;
+  for (size_t j = 0; j < p_len; j++) {
+    const myriota_complex_16 am = a(m0 + j);
+    re += am.re * taps[j];
+    im += am.im * taps[j];
   }
   return (myriota_complex_32){re, im};
 }
@@ -84,6 +346,166 @@ myriota_complex_16 Resample16::operator()(int64_t n) const {
                               myriota_clip_16(x.im / alpha)};
 }
 
+size_t Resample16::process(const myriota_complex_16 *in, size_t nin,
+                           myriota_complex_16 *out, size_t nout_max) {
+  return process_block(*this, n_next, in, nin, out, nout_max);
+}
+
+// Split n into k roughly equal factors. Prime factors are assigned largest
+// first to the smallest partial product, the multiway number partitioning
+// greedy. Returns the factors sorted descending, padded with ones.
+static std::vector<long long> balanced_factors(long long n, const int k) {
+  std::vector<long long> primes;
+  for (long long d = 2; d * d <= n; d++)
+    while (n % d == 0) {
+      primes.push_back(d);
+      n /= d;
+    }
+  if (n > 1) primes.push_back(n);
+  std::vector<long long> f(k, 1);
+  for (size_t i = primes.size(); i > 0; i--) {
+    size_t jmin = 0;
+    for (size_t j = 1; j < f.size(); j++)
+      if (f[j] < f[jmin]) jmin = j;
+    f[jmin] *= primes[i - 1];
+  }
+  std::sort(f.rbegin(), f.rend());
+  return f;
+}
+
+// the window width of a cascade stage converting between the given rates.
+// Stages whose cutoff min(rate, next)/2 sits well above the final band only
+// need the transition to start past the band, so W shrinks in proportion;
+// 6 keeps the transition within the spare bandwidth
+static double stage_W(const double W, const double band, const double rate,
+                      const double next) {
+  return fmax(6.0, fmin(W, W * 2 * band / fmin(rate, next)));
+}
+
+ResampleCascade::ResampleCascade(double in_rate, double out_rate, double W) {
+  const myriota_rational r =
+      myriota_rational_approximation(out_rate / in_rate, 1e-6, 1000, 10);
+  const double band = fmin(in_rate, out_rate) / 2;
+  // Candidate factorings into 1, 2 and 3 stages, the cheapest by estimated
+  // cost per second wins: the polyphase row length (see ResampleTaps) times
+  // the stage output rate, plus a per sample constant approximating buffer
+  // traffic so an extra stage is only taken when the saved multiplies
+  // outweigh its copies. One stage is the ResampleDouble baseline, so ratios
+  // that gain nothing from cascading, e.g. modest xi or a large prime p or
+  // q that does not factor, degenerate to it. Within a factoring the
+  // largest numerator and denominator factors are paired so stage ratios
+  // stay near the geometric mean, identity pairs are dropped, and the most
+  // decimating stage runs first so later stages see the lowest possible
+  // rate (for upsampling this runs the smallest expansion first, the mirror
+  // image optimum).
+  std::vector<myriota_rational> best;
+  double best_cost = 0;
+  for (int k = 1; k <= 3; k++) {
+    const std::vector<long long> fp = balanced_factors(r.p, k);
+    const std::vector<long long> fq = balanced_factors(r.q, k);
+    std::vector<myriota_rational> s;
+    for (int i = 0; i < k; i++)
+      if (fp[i] != fq[i]) s.push_back((myriota_rational){fp[i], fq[i]});
+    if (s.empty()) s.push_back((myriota_rational){1, 1});
+    std::sort(s.begin(), s.end(),
+              [](const myriota_rational &a, const myriota_rational &b) {
+                return a.p * b.q < b.p * a.q;
+              });
+    const double traffic = 16;  // per sample buffer cost in multiplies
+    double cost = 0, rate = in_rate;
+    for (size_t i = 0; i < s.size(); i++) {
+      const double next = rate * s[i].p / s[i].q;
+      const double xi = s[i].p > s[i].q ? s[i].p : s[i].q;
+      cost += (2 * stage_W(W, band, rate, next) * xi / s[i].p + 1 + traffic) *
+                  next +
+              traffic * rate;
+      rate = next;
+    }
+    if (k == 1 || cost < best_cost) {
+      best = s;
+      best_cost = cost;
+    }
+  }
+  double rate = in_rate;
+  for (size_t i = 0; i < best.size(); i++) {
+    const double next = rate * best[i].p / best[i].q;
+    chain.push_back(std::make_shared<ResampleDouble>(
+        rate, next, stage_W(W, band, rate, next)));
+    rate = next;
+  }
+}
+
+size_t ResampleCascade::process(const complex *in, size_t nin, complex *out,
+                                size_t nout_max) {
+  nin_total += nin;
+  // Run the whole of in through the stage chain. A stage's short return
+  // means it consumed all of its input, so draining each stage completely
+  // leaves no samples between stages: the only state between calls is
+  // inside the stages themselves and in the tail of outputs that did not
+  // fit a previous out. Stage 0 reads the caller's buffer directly so the
+  // full rate input is never copied.
+  const size_t last = chain.size() - 1;
+  const complex *src = in;
+  size_t n = nin;
+  for (size_t i = 0; i < last; i++) {
+    std::vector<complex> &dst = mid[i % 2];
+    size_t used = 0, produced = 0;
+    while (true) {
+      const size_t chunk = 1 << 14;
+      dst.resize(produced + chunk);
+      const int64_t pushed0 = chain[i]->pushed();
+      const size_t nout =
+          chain[i]->process(src + used, n - used, dst.data() + produced, chunk);
+      used += chain[i]->pushed() - pushed0;
+      produced += nout;
+      if (nout < chunk) break;
+    }
+    dst.resize(produced);
+    src = dst.data();
+    n = produced;
+  }
+  // out is filled from the tail of earlier calls first. The consumed front
+  // of the tail is recovered once it is at least half the vector, so
+  // maintenance is amortised constant time per sample rather than a front
+  // erase per call.
+  const size_t from_tail = std::min(nout_max, tail.size() - tail_head);
+  std::copy(tail.begin() + tail_head, tail.begin() + tail_head + from_tail,
+            out);
+  tail_head += from_tail;
+  if (tail_head == tail.size()) {
+    tail.clear();
+    tail_head = 0;
+  } else if (tail_head > tail.size() / 2) {
+    tail.erase(tail.begin(), tail.begin() + tail_head);
+    tail_head = 0;
+  }
+  // the final stage writes directly into the space left in out
+  size_t direct = 0, used = 0;
+  while (from_tail + direct < nout_max) {
+    const size_t want = nout_max - from_tail - direct;
+    const int64_t pushed0 = chain[last]->pushed();
+    const size_t nout = chain[last]->process(src + used, n - used,
+                                             out + from_tail + direct, want);
+    used += chain[last]->pushed() - pushed0;
+    direct += nout;
+    if (nout < want) break;  // input exhausted
+  }
+  // the final stage must still consume all input, any further output joins
+  // the tail
+  std::vector<complex> &spill = mid[last % 2];
+  while (used < n) {
+    const size_t chunk = 1 << 14;
+    spill.resize(chunk);
+    const int64_t pushed0 = chain[last]->pushed();
+    const size_t nout =
+        chain[last]->process(src + used, n - used, spill.data(), chunk);
+    used += chain[last]->pushed() - pushed0;
+    tail.insert(tail.end(), spill.data(), spill.data() + nout);
+    if (nout < chunk) break;
+  }
+  return from_tail + direct;
+}
+
 // signed divide by 2^s witout integer division
 static int32_t sdiv(const int32_t x, const int s) {
   if (x >= 0)
@@ -98,4 +520,9 @@ myriota_complex_16 Resample16shift::operator()(int64_t n) const {
                               myriota_clip_16(sdiv(x.im, s))};
 }
 
+size_t Resample16shift::process(const myriota_complex_16 *in, size_t nin,
+                                myriota_complex_16 *out, size_t nout_max) {
+  return process_block(*this, n_next, in, nin, out, nout_max);
+}
+
 }  // namespace myriota
@@ -117,6 +117,9 @@ static inline double myriota_acos(double x) { return pi / 2 - asin(x); }
 unsigned long myriota_factorial(unsigned int n);
 
 // Returns the value of the nth modified Bessel function at x.
+// Evaluated by Miller's downward recurrence, switching to the asymptotic
+// expansion for arguments large relative to the order, accurate to near
+// machine precision for all orders.
 double myriota_besselI(int n, double x);
 
 // Parses a base64 string into a buffer of bytes.
@@ -231,9 +234,52 @@ static inline unsigned long myriota_long_div_ceil(unsigned long a,
   return a / b + (a % b != 0);
 }
 
-// Number uniformly distributed on the interval [0,1]
+// Random number generator (xoshiro256++) with explicit state, so each
+// thread, e.g. of a Monte-Carlo simulation, owns its own stream and no
+// global lock is taken. The one-off myriota_random helpers below wrap a
+// process-global state and remain convenient for single threaded use.
+typedef struct {
+  uint64_t s[4];
+} myriota_rng;
+
+// Seed the generator. Any seed is valid and different seeds give unrelated
+// streams.
+void myriota_rng_init(myriota_rng *rng, uint64_t seed);
+
+// Advance rng by 2^128 steps. Starting from a common seed, 2^128 calls of
+// myriota_rng_jump generate non-overlapping subsequences of length 2^128,
+// one per thread.
+void myriota_rng_jump(myriota_rng *rng);
+
+// Next 64 uniformly random bits
+uint64_t myriota_rng_next(myriota_rng *rng);
+
+// Number uniformly distributed on the interval [0,1)
+double myriota_rng_uniform(myriota_rng *rng);
+
+// Generate a Bernoulli observation with success probability p
+int myriota_rng_bernoulli(myriota_rng *rng, double p);
+
+// Generate a geometric observation with success probability p
+int myriota_rng_geometric(myriota_rng *rng, double p);
+
+// Generate a normally distributed random variable
+double myriota_rng_normal(myriota_rng *rng);
+
+// Generate an exponentially distributed random variable
+double myriota_rng_exponential(myriota_rng *rng, const double mean);
+
+// Sample from discrete probability mass function p of length n. p will be
+// normalised to sum to one prior to sampling
+int myriota_rng_discrete(myriota_rng *rng, const double *p, int n);
+
+// The process-global generator state used by the myriota_random helpers.
+// Deterministically seeded on first use.
+myriota_rng *myriota_rng_default(void);
+
+// Number uniformly distributed on the interval [0,1)
 static inline double myriota_random_uniform() {
-  return ((double)rand()) / RAND_MAX;
+  return myriota_rng_uniform(myriota_rng_default());
 }
 
 // Generate a Bernoulli observation with success probability p
@@ -312,6 +358,23 @@ double myriota_solve(double (*f)(double, void *), void *fdata, const double y,
 double myriota_minimise(double (*f)(double, void *), void *fdata,
                         const double a, const double b, const double tol);
 
+// As myriota_bisection but using Brent's method, combining inverse quadratic
+// interpolation and the secant rule with a bisection fallback, so clean
+// functions converge superlinearly, typically an order of magnitude fewer
+// evaluations of f for tight tolerances. Requires sign(f(a)) = -sign(f(b)).
+// At most max_evals evaluations of f are performed, returning the best
+// bracketed estimate if the cap is reached first.
+double myriota_brent_root(double (*f)(double, void *), void *fdata,
+                          const double ax, const double bx, const double tol,
+                          const int max_evals);
+
+// As myriota_minimise but using Brent's method, golden section search with
+// successive parabolic interpolation, and a cap of max_evals evaluations
+// of f
+double myriota_brent_minimise(double (*f)(double, void *), void *fdata,
+                              const double ax, const double bx,
+                              const double tol, const int max_evals);
+
 // integrate the function f from a to infinity using the substitution x = a +
 // (t/(1-t)) and N steps
 double myriota_integrate_infty(double (*f)(double, void *), void *fdata,
@@ -338,6 +401,18 @@ double myriota_integrate_infty(double (*f)(double, void *), void *fdata,
 //    y[n] =  myriota_unwrap(x[n], y[n-1]);
 double myriota_unwrap(const double value, const double previous_value);
 
+// Unwrap a whole buffer of wrapped phase. Equivalent to the myriota_unwrap
+// loop above but computes the wrapped first differences in an independent
+// pass that the compiler can vectorise, leaving only a cheap running sum.
+// in and out may be the same buffer.
+void myriota_unwrap_array(const double *in, double *out, const size_t n);
+
+// Fixed point variant for phase stored in turns as a 32 bit fraction of a
+// cycle, i.e. 2^32 is one cycle, the same convention as myriota_sin_16. The
+// wrapped difference falls out of two's complement arithmetic. Output is 64
+// bit so arbitrarily long records cannot overflow.
+void myriota_unwrap_array_32(const int32_t *in, int64_t *out, const size_t n);
+
 // Circularly rotate array of integers to the right n times.
 // Modifies input array inplace. The array has the size specified by the size
 // argument.
@@ -360,6 +435,14 @@ void myriota_rotate(int *array, int size, int n);
 // r is now {1,1,0,0,1,0,1}
 void myriota_msequence(const int N, int *r);
 
+// Like myriota_msequence but word packed: emits the 2^N-1 sequence bits into
+// a bit buffer compatible with myriota_get_bit, r of size at least
+// (2^N-1+7)/8 bytes. The shift register advances several bits per shift-XOR
+// word operation rather than one bit per loop, and N up to 24 is supported
+// for long correlation references. For N <= 14 the sequence is identical to
+// myriota_msequence.
+void myriota_msequence_bits(const int N, uint8_t *r);
+
 // Like the standard qsort but also removes duplicates. Returns the number of
 // unique elements.
 int myriota_sort_unique(void *base, size_t nitems, size_t size,
@@ -390,17 +473,166 @@ static inline myriota_complex_32 myriota_complex_sum_32(
   return (myriota_complex_32){a.re + b.re, a.im + b.im};
 }
 
+// Fixed point sine and cosine. The phase is in turns as an unsigned 32 bit
+// fraction of a full cycle, i.e. 2^32 is one cycle, so the phase wraps
+// naturally with unsigned arithmetic. Returns 1.15 fixed point in
+// [-2^15+1, 2^15-1]. Uses a quarter wave table with linear interpolation,
+// accurate to within 2 units in the last place, no floating point arithmetic
+// is performed.
+int16_t myriota_sin_16(const uint32_t theta);
+int16_t myriota_cos_16(const uint32_t theta);
+
+// Numerically controlled oscillator for rotating 16 bit fixed point sample
+// blocks by an advancing phasor entirely in integer arithmetic
+typedef struct {
+  uint32_t phase;  // current phase in turns, 2^32 is one cycle
+  uint32_t step;   // phase increment per sample
+} myriota_nco_16;
+
+// Initialise NCO with frequency f in cycles per sample, e.g. a frequency in
+// Hz divided by the sample rate, and initial phase in cycles
+void myriota_nco_init_16(myriota_nco_16 *nco, const double f,
+                         const double phase);
+
+// The phasor e^(2 pi i phase) in 1.15 fixed point, advancing the NCO by one
+// sample
+myriota_complex_16 myriota_nco_next_16(myriota_nco_16 *nco);
+
+// Multiply n samples of in by the advancing phasor, i.e.
+// out[k] = in[k] e^(2 pi i (phase + k f)), rounded to 16 bit. in and out may
+// be the same buffer
+void myriota_nco_rotate_16(myriota_nco_16 *nco, const myriota_complex_16 *in,
+                           myriota_complex_16 *out, const size_t n);
+
+// In-place radix-2 fast Fourier transform of length n.
+// n must be a power of two.
+void myriota_fft(myriota_complex *x, const unsigned int n);
+
+// In-place inverse fast Fourier transform of length n, normalised by 1/n so
+// that myriota_ifft inverts myriota_fft. n must be a power of two.
+void myriota_ifft(myriota_complex *x, const unsigned int n);
+
+// In-place radix-2 fast Fourier transform of length n on 16 bit fixed point
+// samples, e.g. a capture buffer. n must be a power of two.
+//
+// Uses block floating point scaling: before each stage the whole block is
+// shifted right just far enough that the butterflies cannot overflow. Returns
+// the total number of shifts s, i.e. the output is the discrete Fourier
+// transform of the input divided by 2^s.
+int myriota_fft_16(myriota_complex_16 *x, const unsigned int n);
+
+// Inverse of myriota_fft_16, without the 1/n normalisation. Returns the
+// number of shifts s, i.e. the output is n times the inverse discrete Fourier
+// transform of the input divided by 2^s.
+int myriota_ifft_16(myriota_complex_16 *x, const unsigned int n);
+
 #ifdef __cplusplus
 }
 
+#include <algorithm>
+#include <atomic>
 #include <complex>
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 namespace myriota {
 
 typedef std::complex<double> complex;
 
+// Returns int x modulo int y, i.e., the coset representative from
+// {0,1,...,y-1} of x from the group Z/y.
+//
+// Different from x % y when x is negative. This is not the same
+// as the remainder of x after division by y when x is negative
+//
+// The templated type T must implement the % and + operators, e.g. int64_t.
+template <class T>
+T mod(const T &x, const T &y) {
+  const T t = x % y;
+  if (t < 0) return t + y;
+  return t;
+}
+
+// In-place least significant digit radix sort for 32 or 64 bit integer
+// keys, a byte per pass. Signed keys are handled by flipping the sign bit
+// when digits are extracted. No comparator is called, so large integer sets,
+// e.g. timestamps, sort several times faster than through qsort.
+template <typename T>
+void radix_sort(T *x, const size_t n) {
+  static_assert(std::is_integral<T>::value &&
+                    (sizeof(T) == 4 || sizeof(T) == 8),
+                "radix_sort requires 32 or 64 bit integer keys");
+  typedef typename std::make_unsigned<T>::type U;
+  if (n < 2) return;
+  const U flip = std::is_signed<T>::value ? (U)1 << (8 * sizeof(T) - 1) : 0;
+  std::vector<T> tmp(n);
+  T *src = x;
+  T *dst = tmp.data();
+  for (size_t pass = 0; pass < sizeof(T); pass++) {
+    const unsigned int shift = 8 * pass;
+    size_t count[256] = {0};
+    for (size_t i = 0; i < n; i++)
+      count[(((U)src[i] ^ flip) >> shift) & 0xFF]++;
+    size_t offset[256];
+    size_t sum = 0;
+    for (int b = 0; b < 256; b++) {
+      offset[b] = sum;
+      sum += count[b];
+      if (count[b] == n) break;  // all keys share this digit, skip the pass
+    }
+    if (count[(((U)src[0] ^ flip) >> shift) & 0xFF] == n) continue;
+    for (size_t i = 0; i < n; i++)
+      dst[offset[(((U)src[i] ^ flip) >> shift) & 0xFF]++] = src[i];
+    std::swap(src, dst);
+  }
+  // an even number of passes ran, or some were skipped; copy back if the
+  // sorted data ended in the scratch buffer
+  if (src != x) memcpy(x, src, n * sizeof(T));
+}
+
+template <typename T>
+inline void sort_keys(T *x, const size_t n, std::true_type) {
+  // counting passes only pay off beyond a few cache lines of keys
+  if (n < 128)
+    std::sort(x, x + n);
+  else
+    radix_sort(x, n);
+}
+template <typename T>
+inline void sort_keys(T *x, const size_t n, std::false_type) {
+  std::sort(x, x + n);
+}
+
+// Sorts base in place and removes duplicates, the C++ counterpart of
+// myriota_sort_unique with inlined comparisons instead of a comparator
+// callback per element. 32 and 64 bit integer keys take the radix_sort
+// path. Returns the number of unique elements, which occupy the front of
+// the range.
+template <typename T>
+size_t sort_unique(T *base, const size_t nitems) {
+  if (base == NULL || nitems == 0) return 0;
+  sort_keys(base, nitems,
+            std::integral_constant<bool, std::is_integral<T>::value &&
+                                             (sizeof(T) == 4 ||
+                                              sizeof(T) == 8)>());
+  return std::unique(base, base + nitems) - base;
+}
+
+// As above, erasing the duplicates from the vector
+template <typename T>
+size_t sort_unique(std::vector<T> &v) {
+  v.resize(sort_unique(v.data(), v.size()));
+  return v.size();
+}
+
+// Compile time counterpart of myriota_greater_power_of_two
+constexpr unsigned int greater_power_of_two(unsigned int x,
+                                            unsigned int p = 1) {
+  return p >= x ? p : greater_power_of_two(x, 2 * p);
+}
+
 // Type generic circular buffer class that supports sequential write and
 // random access.
 //
@@ -437,13 +669,25 @@ class CircularBuffer {
   // Read the nth element of the buffer
   inline const T &operator()(const int64_t n) const { return buf[n & mask]; }
 
-  void set(const int64_t n, const T &v) {
-    if (n >= minn() && n <= maxn())
+  // Read-only access to the underlying storage. Element n resides at index
+  // n & mask. Intended for kernels that stream through a run of consecutive
+  // elements without paying per-element indexing.
+  inline const T *data() const { return buf.data(); }
+
+  // Write the nth element, valid for n between minn() and maxn(). Returns
+  // true on success. Out of range writes throw std::out_of_range, or with
+  // MYRIOTA_MATH_NO_EXCEPTIONS defined are ignored and report false.
+  bool set(const int64_t n, const T &v) {
+    if (n >= minn() && n <= maxn()) {
       buf[n & mask] = v;
-    else
-      throw std::out_of_range("circluar buffer set " + std::to_string(n) +
-                              " outside [" + std::to_string(minn()) + ", " +
-                              std::to_string(maxn()) + "]");
+      return true;
+    }
+#ifndef MYRIOTA_MATH_NO_EXCEPTIONS
+    throw std::out_of_range("circluar buffer set " + std::to_string(n) +
+                            " outside [" + std::to_string(minn()) + ", " +
+                            std::to_string(maxn()) + "]");
+#endif
+    return false;
   }
 
  protected:
@@ -451,6 +695,112 @@ class CircularBuffer {
   uint64_t N;
 };
 
+// CircularBuffer with template fixed capacity and storage inside the object,
+// no heap allocation and no throwing paths, so it can be instantiated in
+// firmware built without malloc or exception machinery. Holds at least
+// MinSize elements, the capacity is rounded up to a power of two as for
+// CircularBuffer. set never throws, out of range writes report false.
+template <typename T, unsigned int MinSize>
+class CircularBufferStatic {
+ public:
+  static constexpr unsigned int size = greater_power_of_two(MinSize + 1);
+  static constexpr unsigned int mask = size - 1;
+
+  CircularBufferStatic(T init = T()) : N(0) {
+    for (unsigned int i = 0; i < size; i++) buf[i] = init;
+  }
+  inline void push(const T &elem) {
+    buf[N & mask] = elem;
+    N++;
+  }
+  inline uint64_t pushed() const { return N; }
+  inline int64_t maxn() const { return N - 1; }
+  inline int64_t minn() const { return N - size; }
+  inline const T &operator()(const int64_t n) const { return buf[n & mask]; }
+  inline const T *data() const { return buf; }
+  bool set(const int64_t n, const T &v) {
+    if (n < minn() || n > maxn()) return false;
+    buf[n & mask] = v;
+    return true;
+  }
+
+ protected:
+  T buf[size];
+  uint64_t N;
+};
+
+// Lock free single-producer single-consumer variant of CircularBuffer.
+//
+// One thread may push while another concurrently reads and pops, with no
+// locks, e.g. a capture thread feeding Resample::push while a worker drains
+// resampler outputs on another core. Unlike CircularBuffer, push does not
+// overwrite: it fails when the buffer is full and the consumer must pop to
+// free space. Elements n with minn() <= n <= maxn() may be read by the
+// consumer with operator() before being released by pop.
+//
+// As with CircularBuffer the size is increased to a power of two for cheap
+// masked indexing. The head and tail indices are atomic with acquire/release
+// ordering and live on separate cache lines so the two cores do not
+// false-share.
+template <typename T>
+class CircularBufferSPSC {
+ public:
+  const unsigned int size;
+  const unsigned int mask;
+
+  CircularBufferSPSC(unsigned int size)
+      : size(myriota_greater_power_of_two(size + 1)),
+        mask(this->size - 1),
+        buf(this->size),
+        head(0),
+        tail(0){};
+
+  // Producer only. Write an element to the end of the buffer, returns false
+  // without writing if the buffer is full.
+  inline bool push(const T &elem) {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == size) return false;
+    buf[h & mask] = elem;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. Remove the oldest element into elem, returns false if the
+  // buffer is empty.
+  inline bool pop(T &elem) {
+    const uint64_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) == t) return false;
+    elem = buf[t & mask];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // The total number of elements that have been pushed into this buffer.
+  inline uint64_t pushed() const {
+    return head.load(std::memory_order_acquire);
+  }
+
+  // The total number of elements that have been popped from this buffer.
+  inline uint64_t popped() const {
+    return tail.load(std::memory_order_acquire);
+  }
+
+  // Consumer only. The maximum and minimum values of n for which this(n) is
+  // valid. maxn() < minn() when the buffer is empty.
+  inline int64_t maxn() const { return pushed() - 1; }
+  inline int64_t minn() const { return tail.load(std::memory_order_relaxed); }
+
+  // Consumer only. Read the nth element of the buffer, valid for n between
+  // minn() and maxn()
+  inline const T &operator()(const int64_t n) const { return buf[n & mask]; }
+
+ protected:
+  std::vector<T> buf;
+  // producer and consumer indices on their own cache lines
+  alignas(64) std::atomic<uint64_t> head;
+  alignas(64) std::atomic<uint64_t> tail;
+};
+
 template <typename T>
 class Resample {
  public:
@@ -481,17 +831,70 @@ class Resample {
 
  protected:
   CircularBuffer<T> a;
+  // next output sample index for the block process() API of the concrete
+  // classes. Outputs are produced sequentially from index 0.
+  int64_t n_next = 0;
+};
+
+// Immutable resampler filter taps, shared between instances with the same
+// rational resampling ratio and window width through a process-wide cache
+// (see resample_taps in myriotamath.cpp), so constructing many channels of
+// the same ratio costs one tap computation and one copy of the taps.
+//
+// rows holds the taps reorganised into r.p rows of contiguous per phase
+// (polyphase) taps. Row mod(r.q*n, r.p) holds, in order of ascending input
+// index m, the taps the nth output sample is convolved with. Rows are zero
+// padded to equal length row_len so the hot loop is a fixed size dot product
+// that streams linearly through memory and can be evaluated in SIMD lanes
+// (see myriotamath.cpp).
+struct ResampleTaps {
+  std::vector<double> g;     // direct form taps, indexed from gmin
+  std::vector<double> rows;  // polyphase rows
+  size_t row_len;
 };
 
+// Fixed point taps, layout as ResampleTaps
+struct ResampleTaps16 {
+  std::vector<int32_t> f;
+  std::vector<int32_t> rows;
+  size_t row_len;
+  int32_t alpha;  // fixed point output scaling, see Resample16
+};
+
+// Return the shared taps for ratio r and window width W, computing and
+// caching them on first use. Thread safe.
+std::shared_ptr<const ResampleTaps> resample_taps(const myriota_rational r,
+                                                  const double W);
+std::shared_ptr<const ResampleTaps16> resample_taps_16(const myriota_rational r,
+                                                       const double W);
+
+// File backed variant of resample_taps_16 for tools invoked many times:
+// loads dir/resample16_<p>_<q>_<W>.taps into the process wide cache if
+// present, otherwise computes the taps and writes the file for subsequent
+// runs. The fixed point scaling scan dominates Resample16 construction for
+// wide windows while a cached load is a single small read, so repeated
+// invocations start effectively instantly. Files are written via a
+// temporary and rename so concurrent invocations never observe a partial
+// file. Any file error falls back silently to plain computation.
+std::shared_ptr<const ResampleTaps16> resample_taps_16_file(
+    const myriota_rational r, const double W, const char *dir);
+
 class ResampleDouble : public Resample<complex> {
  public:
   // Widow width W can be adjusted, larger is slower, but more accurate
   ResampleDouble(double in_rate, double out_rate, double W = 30);
   virtual complex operator()(int64_t n) const override;
+  // Block processing. Consumes samples from in only as required to produce
+  // output samples sequentially from index 0, stopping once nout_max outputs
+  // are written to out or in is exhausted. Returns the number of outputs
+  // written. The number of inputs consumed can be recovered from pushed().
+  // Avoids per sample virtual dispatch, output is identical to calling
+  // operator() once per output sample.
+  size_t process(const complex *in, size_t nin, complex *out, size_t nout_max);
 
  protected:
-  std::vector<double> g_buf;
-  inline double g(int64_t n) const { return g_buf[n - gmin]; };
+  std::shared_ptr<const ResampleTaps> taps_;
+  inline double g(int64_t n) const { return taps_->g[n - gmin]; };
 };
 
 // Resample 16-bit fixed point input sequence
@@ -501,16 +904,19 @@ class Resample16 : public Resample<myriota_complex_16> {
   // Widow width W can be adjusted, larger is slower, but more accurate
   Resample16(double in_rate, double out_rate, double W = 30);
   myriota_complex_16 operator()(int64_t n) const override;
+  // Block processing, see ResampleDouble::process
+  size_t process(const myriota_complex_16 *in, size_t nin,
+                 myriota_complex_16 *out, size_t nout_max);
   // nth output sample at 32 bit precision
   myriota_complex_32 n32(int64_t n) const;
   double beta() const;        // fixed point scaling paramter
   double g(int64_t n) const;  // double precision filter
   // pack and rescale output to 16 bit range
-  const std::vector<int32_t> &taps() { return f_buf; };  // get filter taps
+  const std::vector<int32_t> &taps() { return taps_->f; };  // get filter taps
 
  protected:
-  std::vector<int32_t> f_buf;
-  inline int32_t f(int64_t n) const { return f_buf[n - gmin]; };
+  std::shared_ptr<const ResampleTaps16> taps_;
+  inline int32_t f(int64_t n) const { return taps_->f[n - gmin]; };
 };
 
 // Resample 16-bit first point input sequence, "avoids" integer division at
@@ -522,21 +928,241 @@ class Resample16shift : public Resample16 {
   Resample16shift(double in_rate, double out_rate, double W = 30)
       : Resample16(in_rate, out_rate, W), s(floor(log2(alpha))){};
   myriota_complex_16 operator()(int64_t n) const override;
+  // Block processing, see ResampleDouble::process
+  size_t process(const myriota_complex_16 *in, size_t nin,
+                 myriota_complex_16 *out, size_t nout_max);
 };
 
-// Returns int x modulo int y, i.e., the coset representative from
-// {0,1,...,y-1} of x from the group Z/y.
+// Cascade of two or three small ratio ResampleDouble stages for large rate
+// changes, e.g. 16 Msps down to 50 ksps.
 //
-// Different from x % y when x is negative. This is not the same
-// as the remainder of x after division by y when x is negative
+// The single stage classes pay a dot product of roughly 2*W/kappa taps per
+// output sample, so a ratio like 50000/16000000 = 1/320 costs about 19200
+// multiplies per output. The cascade factors the reduced rational ratio into
+// stages of small rationals (1/320 = 1/8 * 1/8 * 1/5) so each stage's xi,
+// and with it the tap count, stays small, and relaxes the window width of
+// the stages whose cutoff sits well above the final band: those stages only
+// have to keep aliases out of the final band, so a wide transition, i.e. a
+// small W, suffices, while the stage that sets the band gets the full W and
+// runs at the lowest rate. For the decimation heavy ratios this cuts the
+// total multiply count several fold, approaching W over the relaxed width
+// for strong decimation.
 //
-// The templated type T must implement the % and + operators, e.g. int64_t.
-template <class T>
-T mod(const T &x, const T &y) {
-  const T t = x % y;
-  if (t < 0) return t + y;
-  return t;
+// The stage count (one to three) is chosen by an estimated multiply count,
+// so ratios that gain nothing from cascading, e.g. modest xi or a large
+// prime p or q that does not factor, degenerate to a single ResampleDouble
+// stage. Output is not bit identical to ResampleDouble: the cascaded
+// response is the product of the stage responses rather than a single
+// windowed sinc, though both are zero phase so outputs correspond sample
+// for sample.
+class ResampleCascade {
+ public:
+  // Window width W applies to the band setting stage, see above
+  ResampleCascade(double in_rate, double out_rate, double W = 30);
+  // Block processing, see ResampleDouble::process. Unlike the single stage
+  // classes all of in is always consumed; samples not yet resampled or not
+  // yet fitting in out are buffered internally.
+  size_t process(const complex *in, size_t nin, complex *out, size_t nout_max);
+  // the total number of input samples consumed
+  uint64_t pushed() const { return nin_total; }
+  size_t stages() const { return chain.size(); }
+  const ResampleDouble &stage(size_t i) const { return *chain[i]; }
+
+ private:
+  std::vector<std::shared_ptr<ResampleDouble>> chain;
+  std::vector<complex> mid[2];  // interstage ping pong buffers
+  std::vector<complex> tail;    // outputs that did not fit a previous out
+  size_t tail_head = 0;
+  uint64_t nin_total = 0;
+};
+
+// Compile time math for Resample16Static. C++11 constexpr functions are
+// limited to a single return expression so these are written recursively;
+// sums and maxima over ranges split in half to bound recursion depth.
+namespace cexpr {
+
+constexpr long long abs_ll(long long x) { return x < 0 ? -x : x; }
+constexpr long long gcd(long long a, long long b) {
+  return b == 0 ? abs_ll(a) : gcd(abs_ll(b), abs_ll(a) % abs_ll(b));
+}
+constexpr double abs(double x) { return x < 0 ? -x : x; }
+constexpr double max(double a, double b) { return a > b ? a : b; }
+constexpr double floor(double x) {
+  return (double)(long long)x <= x ? (double)(long long)x
+                                   : (double)(long long)x - 1.0;
+}
+constexpr double ceil(double x) { return -floor(-x); }
+constexpr double round(double x) { return floor(x + 0.5); }
+// Taylor series sine for |x| <= pi/2
+constexpr double sin_series(double x, double term, double sum, int n) {
+  return abs(term) < 1e-22
+             ? sum
+             : sin_series(x, -term * x * x / ((2 * n) * (2 * n + 1)),
+                          sum + term, n + 1);
+}
+// sin(pi*x) and cos(pi*x). The filter only evaluates sine and cosine at
+// multiples of pi so reducing before scaling by pi keeps full precision.
+constexpr double sinpi_reduced(double f) {
+  return sin_series(pi * f, pi * f, 0.0, 1);
+}
+constexpr double sinpi(double x) {
+  return (long long)round(x) % 2 ? -sinpi_reduced(x - round(x))
+                                 : sinpi_reduced(x - round(x));
+}
+constexpr double cospi(double x) { return sinpi(0.5 - x); }
+// constexpr equivalents of myriota_sinc and myriota_blackman
+constexpr double sinc(double t) {
+  return abs(t) < 5e-3 ? 1.0 - t * t * (1.0 / 6 - 1.0 / 120 * t * t)
+                       : sinpi(t) / (pi * t);
 }
+constexpr double blackman(double t, double W) {
+  return (t < -W || t > W)
+             ? 0.0
+             : 21.0 / 50 + 0.5 * cospi(t / W) + 2.0 / 25 * cospi(2 * t / W);
+}
+// the resampler filter g, see ResampleDouble
+constexpr double g(long long t, long long xi, double W) {
+  return sinc((1.0 * t) / xi) * blackman((1.0 * t) / xi, W);
+}
+// sum of |g(q*n - p*l)| over l in [l0, l1)
+constexpr double gsum(long long n, long long l0, long long l1, long long p,
+                      long long q, long long xi, double W) {
+  return l1 <= l0 ? 0.0
+         : l1 - l0 == 1
+             ? abs(g(q * n - p * l0, xi, W))
+             : gsum(n, l0, (l0 + l1) / 2, p, q, xi, W) +
+                   gsum(n, (l0 + l1) / 2, l1, p, q, xi, W);
+}
+constexpr double phase_gsum(long long n, long long p, long long q,
+                            long long xi, double W, double gamma,
+                            double kappa) {
+  return gsum(n, (long long)ceil(n / gamma - W / kappa),
+              (long long)floor(n / gamma + W / kappa) + 1, p, q, xi, W);
+}
+// maximum phase_gsum over phases n in [n0, n1), see Resample16::beta
+constexpr double beta_max(long long n0, long long n1, long long p, long long q,
+                          long long xi, double W, double gamma, double kappa) {
+  return n1 - n0 == 1
+             ? phase_gsum(n0, p, q, xi, W, gamma, kappa)
+             : max(beta_max(n0, (n0 + n1) / 2, p, q, xi, W, gamma, kappa),
+                   beta_max((n0 + n1) / 2, n1, p, q, xi, W, gamma, kappa));
+}
+constexpr double beta(long long p, long long q, long long xi, double W,
+                      double gamma, double kappa) {
+  return kappa * beta_max(0, p, p, q, xi, W, gamma, kappa);
+}
+// a single fixed point tap, see the Resample16 constructor
+constexpr int32_t tap(int i, int gmin, long long xi, double W, double kappa,
+                      int32_t alpha) {
+  return (int32_t)floor(kappa * alpha * g(gmin + i, xi, W));
+}
+
+// integer sequence machinery, C++14 has this in <utility>
+template <int... I>
+struct tap_seq {};
+template <typename A, typename B>
+struct seq_cat;
+template <int... A, int... B>
+struct seq_cat<tap_seq<A...>, tap_seq<B...>> {
+  typedef tap_seq<A..., (B + (int)sizeof...(A))...> type;
+};
+template <int N>
+struct make_seq : seq_cat<typename make_seq<N / 2>::type,
+                          typename make_seq<N - N / 2>::type> {};
+template <>
+struct make_seq<0> {
+  typedef tap_seq<> type;
+};
+template <>
+struct make_seq<1> {
+  typedef tap_seq<0> type;
+};
+
+template <int N>
+struct tap_table {
+  int32_t t[N];
+};
+template <int... I>
+constexpr tap_table<(int)sizeof...(I)> make_taps(tap_seq<I...>, int gmin,
+                                                 long long xi, double W,
+                                                 double kappa, int32_t alpha) {
+  return tap_table<(int)sizeof...(I)>{
+      {tap(I, gmin, xi, W, kappa, alpha)...}};
+}
+
+}  // namespace cexpr
+
+// Resample16 variant for rates known at compile time.
+//
+// Taps, alpha and the window bounds are computed at compile time and placed
+// in read-only storage (flash), and the sample buffer is a fixed size member
+// array, so instances are ready with zero runtime construction work, no heap
+// and no exception machinery. The rate ratio is the exact reduced fraction
+// OutRate/InRate rather than the myriota_rational_approximation of the
+// dynamic classes; taps match Resample16 except for an occasional one unit
+// difference at the sinc zero crossings, where the library sine is a rounding
+// error away from zero. Several such taps can land in one dot product, so
+// outputs may differ from Resample16 by a few least significant bits and
+// are not bit-for-bit comparable. Compile time and flash use grow with the
+// tap count 2*xi*W+1, keep the reduced ratio modest.
+template <long long InRate, long long OutRate, int W = 30>
+class Resample16Static {
+ public:
+  static constexpr long long p = OutRate / cexpr::gcd(InRate, OutRate);
+  static constexpr long long q = InRate / cexpr::gcd(InRate, OutRate);
+  static constexpr double gamma = (1.0 * p) / q;
+  static constexpr double kappa = gamma < 1 ? gamma : 1.0;
+  static constexpr double delta = gamma > 1 ? gamma : 1.0;
+  static constexpr long long xi = p > q ? p : q;
+  static constexpr int gmin = (int)(-xi * W);
+  static constexpr int gmax = (int)(xi * W);
+  static constexpr int ntaps = gmax - gmin + 1;
+  static constexpr int32_t alpha =
+      (int32_t)cexpr::floor((1 << 16) / cexpr::beta(p, q, xi, W, gamma, kappa));
+  typedef CircularBufferStatic<myriota_complex_16,
+                               (unsigned int)cexpr::ceil(2.0 * W / kappa + 1)>
+      Buffer;
+  static constexpr unsigned int size = Buffer::size;
+  static constexpr unsigned int mask = Buffer::mask;
+
+  Resample16Static() {}
+  void push(const myriota_complex_16 &x) { a.push(x); }
+  int64_t pushed() const { return a.pushed(); }
+  int64_t minn() const { return ceil(gamma * (a.maxn() - size) + delta * W); }
+  int64_t maxn() const { return floor(gamma * (a.maxn() - 1) - delta * W); }
+  // nth output sample at 32 bit precision, see Resample16::n32
+  myriota_complex_32 n32(int64_t n) const {
+    const int64_t P = p, Q = q, G = gmax;
+    const int64_t qn = Q * n;
+    const int64_t tmax = G - mod<int64_t>(G - mod<int64_t>(qn, P), P);
+    int32_t re = 0, im = 0;
+    int64_t m = (qn - tmax) / P;
+    for (int64_t t = tmax; t >= gmin; t -= P, m++) {
+      const int32_t fv = taps_.t[t - gmin];
+      const myriota_complex_16 am = a(m);
+      re += am.re * fv;
+      im += am.im * fv;
+    }
+    return (myriota_complex_32){re, im};
+  }
+  myriota_complex_16 operator()(int64_t n) const {
+    const myriota_complex_32 x = n32(n);
+    const int32_t A = alpha;
+    return (myriota_complex_16){myriota_clip_16(x.re / A),
+                                myriota_clip_16(x.im / A)};
+  }
+  static const int32_t *taps() { return taps_.t; }
+
+ protected:
+  static constexpr cexpr::tap_table<ntaps> taps_ = cexpr::make_taps(
+      typename cexpr::make_seq<ntaps>::type(), gmin, xi, W, kappa, alpha);
+  Buffer a;
+};
+
+template <long long InRate, long long OutRate, int W>
+constexpr cexpr::tap_table<Resample16Static<InRate, OutRate, W>::ntaps>
+    Resample16Static<InRate, OutRate, W>::taps_;
+
 }  // namespace myriota
 #endif
 
@@ -87,6 +87,23 @@ int ADCGetVoltage(uint8_t PinNum, ADCReference Reference, uint32_t *mV);
 /// Get raw value from the ADC port (0 - 0xFFF).
 /// Returns 0 if read succeeds and -1 if read fails.
 int ADCGetValue(uint8_t PinNum, ADCReference Reference, uint16_t *Value);
+/// Handler called from interrupt context when an ADC stream fills the
+/// caller's buffer, with the result 0 if the capture succeeded and -1 if it
+/// failed.
+typedef void (*ADCStreamHandler)(int Result);
+/// Stream timer triggered conversions into \p Buffer by DMA at
+/// \p SampleRate conversions per second with the CPU asleep, instead of one
+/// conversion per ADCGetValue call. Every \p Decimate consecutive
+/// conversions are averaged into one buffered value, 1 to store every
+/// conversion, so kilohertz acquisition can be reduced in the driver.
+/// \p Handler is called when \p Samples values have been stored. \p Buffer
+/// must stay valid until then. Returns 0 if the capture was started and -1
+/// if failed.
+int ADCStreamStart(uint8_t PinNum, ADCReference Reference,
+                   uint32_t SampleRate, uint32_t Decimate, uint16_t *Buffer,
+                   size_t Samples, ADCStreamHandler Handler);
+/// Stop a stream before completion. The handler is not called.
+void ADCStreamStop(void);
 
 /// @}
 
@@ -114,6 +131,29 @@ int I2CWrite(uint16_t DeviceAddress, const uint8_t *Command,
 /// Returns 0 if read succeeds and -1 if read fails.
 int I2CRead(uint16_t DeviceAddress, const uint8_t *Command,
             size_t CommandLength, uint8_t *Rx, size_t RxLength);
+/// One segment of a combined I2C transaction. For a write segment \p Tx is
+/// the data and \p Rx is NULL, for a read segment \p Rx is the destination
+/// and \p Tx is NULL.
+typedef struct {
+  const uint8_t *Tx;
+  uint8_t *Rx;
+  size_t Length;
+} I2CSegment;
+/// Handler called from interrupt context when an asynchronous combined
+/// transaction completes, with the result 0 if it succeeded and -1 if it
+/// failed.
+typedef void (*I2CTransferHandler)(int Result);
+/// Execute \p Count segments as one bus transaction with a repeated start
+/// between segments instead of a start/stop cycle per I2CWrite/I2CRead
+/// call, e.g. reading a block of sensor registers in a single transaction.
+/// Returns 0 if the transaction succeeds and -1 if it fails.
+int I2CTransfer(uint16_t DeviceAddress, const I2CSegment *Segments,
+                size_t Count);
+/// Asynchronous I2CTransfer. The segments and their buffers must stay valid
+/// until \p Handler is called. Returns 0 if the transaction was started and
+/// -1 if the bus is busy.
+int I2CTransferAsync(uint16_t DeviceAddress, const I2CSegment *Segments,
+                     size_t Count, I2CTransferHandler Handler);
 
 /// @}
 
@@ -136,6 +176,21 @@ int SPIWrite(const uint8_t *Tx, size_t Length);
 /// SPI data transfer.
 /// Returns 0 if transfer succeeds and -1 if transfer fails.
 int SPITransfer(const uint8_t *Tx, uint8_t *Rx, size_t Length);
+/// Handler called from interrupt context when a queued transfer completes,
+/// with the result 0 if the transfer succeeded and -1 if it failed.
+typedef void (*SPITransferHandler)(int Result);
+/// Queue an SPI transfer to be executed by DMA. Queued transfers run
+/// back-to-back in order without waking the CPU between them, so a burst of
+/// small register reads, e.g. draining a sensor FIFO, is described once and
+/// the MCU can sleep or process during the transfer. \p Tx, \p Rx and any
+/// buffers of transfers queued behind them must stay valid until their
+/// handler is called. \p Handler may be NULL. Returns 0 if the transfer was
+/// queued and -1 if the queue is full.
+int SPIQueueTransfer(const uint8_t *Tx, uint8_t *Rx, size_t Length,
+                     SPITransferHandler Handler);
+/// Block until all queued transfers have completed.
+/// Returns 0 if all succeeded and -1 if any failed.
+int SPIQueueFlush(void);
 
 /// @}
 
@@ -196,6 +251,27 @@ int UARTWrite(void *Handle, const uint8_t *Tx, size_t Length);
 /// Read from input buffer of a UART interface. The buffer size is 50 bytes.
 /// Returns number of bytes read back and -1 if read fails.
 int UARTRead(void *Handle, uint8_t *Rx, size_t Length);
+/// Handler called when the asynchronous receive buffer fills past the
+/// watermark or the line goes idle with bytes pending. Called from interrupt
+/// context, so it should only flag work for a job, e.g. via OnLeuartReceive
+/// or a GPIO wakeup.
+typedef void (*UARTRxHandler)(void *Handle);
+/// Start asynchronous receive on a UART interface. Bytes are moved by DMA
+/// into a driver owned ring buffer of \p BufferSize bytes without waking the
+/// CPU, instead of being polled with UARTRead. \p Handler may be NULL to
+/// only buffer. Returns 0 if succeeded and -1 if failed.
+int UARTReadAsync(void *Handle, size_t BufferSize, size_t Watermark,
+                  UARTRxHandler Handler);
+/// Zero copy access to the received bytes. Points \p Rx at the longest
+/// contiguous run of unread bytes in the ring buffer and returns its length,
+/// 0 if none. The bytes remain valid until released.
+size_t UARTReadBuffer(void *Handle, const uint8_t **Rx);
+/// Release the first \p Length bytes returned by UARTReadBuffer back to the
+/// ring buffer.
+void UARTReadRelease(void *Handle, size_t Length);
+/// Stop asynchronous receive and free the ring buffer. Unread bytes are
+/// discarded.
+void UARTReadAsyncStop(void *Handle);
 
 /// @}
 
@@ -220,6 +296,24 @@ int PulseCounterInit(uint32_t Limit, uint32_t Options);
 /// Get the total count of the pulse counter.
 /// Returns the total count.
 uint64_t PulseCounterGet(void);
+/// A timestamped pulse counter capture, see PulseCounterCaptureStart.
+typedef struct {
+  uint32_t Tick;   ///< system tick of the capture, see TickGet
+  uint64_t Count;  ///< total count at the capture
+} PulseCounterCapture;
+/// Record a (tick, count) capture into a driver buffer of \p Captures
+/// entries every \p Interval counts, without waking the CPU. The
+/// application drains the buffer in one PulseCounterCaptureRead call per
+/// wake instead of waking to sample the counter for every point of a
+/// profile. When the buffer is full the oldest captures are overwritten.
+/// Returns 0 if succeeded and -1 if failed.
+int PulseCounterCaptureStart(uint32_t Interval, size_t Captures);
+/// Read and consume up to \p MaxCaptures buffered captures, oldest first.
+/// Returns the number of captures read.
+size_t PulseCounterCaptureRead(PulseCounterCapture *Captures,
+                               size_t MaxCaptures);
+/// Stop capturing and free the capture buffer.
+void PulseCounterCaptureStop(void);
 /// Deinitialise the pulse counter.
 void PulseCounterDeinit(void);
 
@@ -252,6 +346,29 @@ int RFTestRxStart(uint32_t Frequency);
 /// \p RSSI is in dBm.
 /// Returns 0 if succeeded and -1 if failed.
 int RFTestRxRSSI(int32_t *RSSI);
+/// RSSI statistics over one sampling interval, values in dBm.
+typedef struct {
+  int32_t Min;
+  int32_t Max;
+  int32_t Mean;
+  int32_t Median;
+  int32_t Percentile10;  ///< 10th percentile
+  int32_t Percentile90;  ///< 90th percentile
+  uint32_t Samples;      ///< samples in the interval
+} RSSIStats;
+/// Sample RSSI in the driver at \p SampleRate samples per second, reducing
+/// every \p IntervalMs milliseconds to an #RSSIStats buffered for batch
+/// retrieval, so a site survey gets dense interference statistics without a
+/// host round-trip per sample. The receiver must be on, see RFTestRxStart.
+/// When the buffer is full the oldest intervals are overwritten.
+/// Returns 0 if succeeded and -1 if failed.
+int RFTestRxRSSIStreamStart(uint32_t SampleRate, uint32_t IntervalMs);
+/// Read and consume up to \p MaxStats buffered intervals, oldest first.
+/// Returns the number of intervals read.
+size_t RFTestRxRSSIStreamRead(RSSIStats *Stats, size_t MaxStats);
+/// Stop RSSI sampling. Buffered intervals remain readable until
+/// RFTestRxStop.
+void RFTestRxRSSIStreamStop(void);
 /// Stop the RF Rx test.
 void RFTestRxStop(void);
 
@@ -70,6 +70,28 @@ typedef time_t (*ScheduledJob)(void);
 /// Reset the schedule for an existing job or add a new job.
 /// Return 0 if succeeded and -1 if maximum number of jobs reached.
 int ScheduleJob(ScheduledJob Job, time_t Time);
+/// Raise the maximum number of jobs from the default. Next job selection is
+/// by deadline heap, so dispatch stays logarithmic in the job count. Must be
+/// called from AppInit before any job is scheduled.
+/// Return 0 if succeeded and -1 if \p MaxJobs cannot be satisfied.
+int ScheduleJobCapacity(unsigned MaxJobs);
+/// Per job statistics, see ScheduleJobStats.
+typedef struct {
+  time_t LastRunTime;     ///< when the job last ran
+  uint32_t LastRunMs;     ///< duration of the last run in milliseconds
+  uint32_t RunCount;      ///< times the job has run since startup
+  uint32_t OverrunCount;  ///< runs started later than the scheduled time
+} JobStats;
+/// Get the statistics of a scheduled job.
+/// Return 0 if succeeded and -1 if \p Job is not scheduled.
+int ScheduleJobStats(ScheduledJob Job, JobStats *Stats);
+/// Like ScheduleJob, but allow the job to run up to \p MaxDelay seconds
+/// after \p Time so the scheduler can coalesce jobs whose windows overlap
+/// into a single wakeup, saving the sleep exit and entry cost of waking for
+/// each job separately. Jobs that must run at an exact time should use
+/// ScheduleJob, which is equivalent to a \p MaxDelay of zero.
+/// Return 0 if succeeded and -1 if maximum number of jobs reached.
+int ScheduleJobWithSlack(ScheduledJob Job, time_t Time, unsigned MaxDelay);
 time_t ASAP(void);
 time_t Never(void);
 time_t SecondsFromNow(unsigned Secs);
@@ -82,16 +104,39 @@ time_t OnGPIOWakeup(void);
 time_t OnPulseCounterEvent(void);
 /// Leuart activity event
 time_t OnLeuartReceive(void);
+/// Completion of an asynchronous GNSS fix, see GNSSFixAsync
+time_t OnGNSSFixComplete(void);
 /// Return a time after \p After and before \p Before immediately prior to a
 /// satellite transmit opportunity. Can be used to reduce latency between sensor
 /// reading and satellite transmission. If no opportunity is found between \p
 /// After and \p Before, then \p Before is returned.
 time_t BeforeSatelliteTransmit(time_t After, time_t Before);
+/// A satellite transmit opportunity, see NextTransmitOpportunities.
+typedef struct {
+  time_t Time;          ///< start of the opportunity
+  uint32_t Duration;    ///< duration in seconds
+  uint8_t Quality;      ///< relative link quality, 0 worst to 255 best
+} TransmitOpportunity;
+/// Return in \p Opportunities the next \p N transmit opportunities after
+/// \p After, running the underlying pass prediction once rather than once
+/// per BeforeSatelliteTransmit call. Can be used to plan how many readings
+/// to take and batch before each opportunity. Returns the number of
+/// opportunities found, which may be less than \p N.
+size_t NextTransmitOpportunities(time_t After,
+                                 TransmitOpportunity *Opportunities,
+                                 size_t N);
 /// Return a time to schedule next message to achieve the maximum message
 /// throughput. The function is best suited to near-periodic message scheduling
 /// where the period will adapt to the current satellite network, ensuring
 /// the number of messages is limited to \p MaxMessagesPerDay.
 time_t MaxThroughput(unsigned MaxMessagesPerDay);
+/// Keep the pass prediction and throughput adaptation state behind
+/// BeforeSatelliteTransmit and MaxThroughput in the module's persistent
+/// storage, in the same store used by SaveMessages, so the first scheduling
+/// decision after a reset is as good as the steady state instead of being
+/// rebuilt from scratch. Set true to enable and false to disable. Has no
+/// effect if already in the same state.
+void SchedulingStatePersistEnable(bool Enable);
 /// @}
 
 /// @defgroup User_message User message
@@ -108,12 +153,42 @@ time_t MaxThroughput(unsigned MaxMessagesPerDay);
 /// messages. See also MessageBytesFree. Returns >=0 when succeeded or <0 if
 /// failed.
 float ScheduleMessage(const uint8_t *Message, size_t MessageSize);
+/// Schedule \p Count messages laid out \p Stride bytes apart starting at
+/// \p Messages, each of up to #MAX_MESSAGE_SIZE bytes, with the queue
+/// bookkeeping done once for the whole batch rather than per message. As
+/// with ScheduleMessage each message consumes MAX_MESSAGE_SIZE bytes of
+/// queue space and may replace existing messages when the queue is full.
+/// Returns the number of messages scheduled or <0 if failed.
+int ScheduleMessages(const uint8_t *Messages, size_t Count, size_t Stride);
+/// Reserve the next message slot in the internal queue so the application
+/// can serialise a message directly into queue storage, avoiding the copy
+/// that ScheduleMessage makes from an intermediate buffer. The slot is
+/// MAX_MESSAGE_SIZE bytes. Returns null if the number of bytes returned by
+/// MessageBytesFree is less than MAX_MESSAGE_SIZE. The reservation must be
+/// completed with MessageCommit before MessageReserve or ScheduleMessage is
+/// called again.
+uint8_t *MessageReserve(void);
+/// Schedule the first \p MessageSize bytes of the slot returned by the
+/// matching MessageReserve for transmission. Regardless of the value of
+/// \p MessageSize the number of bytes consumed is MAX_MESSAGE_SIZE.
+/// Returns >=0 when succeeded or <0 if failed, the reservation is released
+/// either way.
+float MessageCommit(size_t MessageSize);
 /// Returns number of bytes remaining in internal queue, that is,
 /// the number of bytes that can be scheduled with ScheduleMessage.
 size_t MessageBytesFree(void);
 /// Save all messages in the message queue to module's persistent storage.
-/// Saved messages will be transmitted after reset.
+/// Saved messages will be transmitted after reset. The store is an
+/// append-only wear-levelled log: a save writes only the entries changed
+/// since the last save, and the log is replayed and compacted at boot, so
+/// repeated saves of a mostly unchanged queue cost flash writes and awake
+/// time in proportion to the changes rather than the queue size.
 void SaveMessages(void);
+/// Save only the messages added since the last save, appending to the
+/// module's persistent storage instead of rewriting the whole queue. Flash
+/// write volume and the associated awake time scale with the number of new
+/// messages rather than the queue size.
+void SaveNewMessages(void);
 /// Clear all messages in the message queue.
 void MessageQueueClear(void);
 
@@ -140,6 +215,20 @@ void Sleep(uint32_t Sec);
 /// Updates real-time clock and latitude and longitude values.
 /// Returns 0 if GNSS fix was correctly obtained and -1 otherwise.
 int GNSSFix(void);
+/// Start a GNSS fix without blocking the calling job. The acquisition runs
+/// in the background and jobs scheduled with OnGNSSFixComplete run when it
+/// finishes, the calling job can return and do other work meanwhile.
+/// Returns 0 if the acquisition was started and -1 if one is already in
+/// progress.
+int GNSSFixAsync(void);
+/// Result of the last asynchronous fix. Returns 0 if it succeeded, -1 if it
+/// failed and 1 if it is still in progress.
+int GNSSFixAsyncResult(void);
+/// Keep ephemeris, almanac and last position in the module's persistent
+/// storage so fixes hot start instead of searching from scratch, reducing
+/// warm fix time from minutes to seconds. Set true to enable and false to
+/// disable. Has no effect if already in the same state.
+void GNSSHotStartEnable(bool Enable);
 /// Returns true if the system has obtained a valid time and location fix.
 bool HasValidGNSSFix(void);
 /// Returns last recorded latitude and longitude in fixed point format and
@@ -192,6 +281,35 @@ uint32_t TickGet(void);
 
 /// @}
 
+/// @defgroup Profiling Profiling counters
+/// Attribution of awake time to the subsystems that consume it. The
+/// counters cost a few cycles per event and are intended to stay enabled in
+/// production builds. Per job runtimes are available via ScheduleJobStats.
+/// @{
+
+/// Cumulative counters since startup or the last ProfilingReset.
+typedef struct {
+  uint32_t AwakeMs;       ///< total time out of sleep
+  uint32_t JobMs;         ///< time spent running user jobs
+  uint32_t RadioTxMs;     ///< radio transmit airtime
+  uint32_t GNSSMs;        ///< GNSS acquisition time
+  uint32_t PeripheralMs;  ///< blocking peripheral I/O time
+  uint32_t WakeupCount;   ///< sleep exits
+} ProfilingCounters;
+/// Get the profiling counters.
+void ProfilingGet(ProfilingCounters *Counters);
+/// Reset the profiling counters to zero.
+void ProfilingReset(void);
+/// Number of user-defined profiling counters.
+#define PROFILING_USER_COUNTERS 8
+/// Add \p Count to user-defined counter \p Index (0 to
+/// #PROFILING_USER_COUNTERS - 1).
+void ProfilingUserAdd(unsigned Index, uint32_t Count);
+/// Get the value of user-defined counter \p Index.
+uint32_t ProfilingUserGet(unsigned Index);
+
+/// @}
+
 /// @defgroup Error_logging Error logging
 /// @{
 
@@ -199,6 +317,17 @@ uint32_t TickGet(void);
 /// The size can be 0 to log only the error code
 /// Returns 0 if logging succeeds and -1 if logging fails.
 int LogAdd(uint8_t ErrorCode, const void *Buffer, uint8_t BufferSize);
+/// Stage LogAdd records in a RAM buffer of \p BufferSize bytes instead of
+/// committing each record to flash synchronously, so a burst of LogAdd
+/// calls costs one flash transaction. Staged records are written by
+/// LogFlush and automatically before sleep. When the buffer overflows the
+/// oldest staged records are dropped and counted. Pass 0 to return to
+/// synchronous commits. Returns 0 if succeeded and -1 if failed.
+int LogDeferredCommit(size_t BufferSize);
+/// Commit staged log records to flash in one transaction. Returns the
+/// number of records dropped to overflow since the last flush, or -1 if
+/// the write failed.
+int LogFlush(void);
 
 /// @}
 
@@ -14,6 +14,8 @@
 #ifndef MYRIOTA_HARDWARE_SIM_API_H
 #define MYRIOTA_HARDWARE_SIM_API_H
 
+#include <inttypes.h>
+#include <stddef.h>
 #include <time.h>
 
 #ifdef __cplusplus
@@ -31,6 +33,45 @@ extern "C" {
 /// Next. A return value of 0 indicates no wakeup event.
 time_t ScheduleHook(time_t Next);
 
+/// Run the simulation against a virtual clock instead of real time. TimeGet,
+/// Delay, Sleep and the job scheduler advance simulated time instantly
+/// between events, so a week of device behaviour, e.g. the tracker example's
+/// 8 to 24 hour cadence, simulates in seconds. Set \p Compression to 0 for
+/// fully event driven time, or to N to advance simulated time at N times
+/// real time. Call from AppInit, before any job runs.
+void VirtualClockEnable(unsigned Compression);
+/// Return the simulation to real time from the current simulated time.
+void VirtualClockDisable(void);
+
+/// @}
+
+/// @defgroup fleet_sim Fleet simulation
+/// Runs many isolated instances of the application in one process, each with
+/// its own location, schedule and message queue, on a thread pool against
+/// the shared virtual clock, to size network capacity before deployments.
+/// @{
+
+/// A simulated device of the fleet.
+typedef struct {
+  uint32_t DeviceId;  ///< reported to the message handler
+  int32_t Latitude;   ///< degrees multiplied by 1e7, as for LocationSet
+  int32_t Longitude;  ///< degrees multiplied by 1e7, as for LocationSet
+  time_t StartTime;   ///< simulated time at which the device boots
+} FleetDevice;
+/// Called for every message a simulated device schedules for transmission.
+/// May be called concurrently from the worker threads.
+typedef void (*FleetMessageHandler)(uint32_t DeviceId, time_t Time,
+                                    const uint8_t *Message,
+                                    size_t MessageSize);
+/// Run \p Count devices for \p Duration simulated seconds on \p Threads
+/// worker threads. Each device runs an isolated instance of the application,
+/// AppInit and its jobs, against the shared virtual clock. \p Handler, which
+/// may be NULL, receives every scheduled message. Replaces the normal single
+/// device simulation when called from main before AppInit.
+/// Returns 0 if the whole fleet ran and -1 if failed.
+int FleetRun(const FleetDevice *Devices, size_t Count, uint32_t Duration,
+             unsigned Threads, FleetMessageHandler Handler);
+
 /// @}
 
 #ifdef __cplusplus
@@ -0,0 +1,156 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks for hot math library functions on deterministic inputs,
+// reporting cycles per sample (or per byte) and MB/s so releases and
+// compiler flag changes (math/flags.mk) can be compared quantitatively.
+//
+// Build with `make bench` and run with no arguments. Cycle counts use the
+// time stamp counter on x86 and the virtual counter on 64-bit ARM; on other
+// platforms the cycles column reports nanoseconds instead.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <functional>
+#include <vector>
+#include "math/myriotacommon.h"
+#include "math/myriotamath.h"
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+static inline uint64_t cycles() { return __rdtsc(); }
+static const char *cycles_unit = "cycles";
+#elif defined(__aarch64__)
+static inline uint64_t cycles() {
+  uint64_t c;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(c));
+  return c;
+}
+static const char *cycles_unit = "counts";
+#else
+static inline uint64_t cycles() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec * 1000000000ull + t.tv_nsec;
+}
+static const char *cycles_unit = "ns";
+#endif
+
+static double seconds() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+// sink so the compiler cannot discard benchmarked work
+static volatile uint64_t sink;
+
+// Run f repeatedly for at least 0.2 seconds after one warm up call and
+// report the per unit cost, where f processes `units` items of `bytes`
+// total per call
+static void bench(const char *name, const char *unit, const size_t units,
+                  const size_t bytes, std::function<void()> f) {
+  f();  // warm up, faults pages and warms caches and branch predictors
+  uint64_t c0 = cycles();
+  double t0 = seconds(), t1;
+  size_t iters = 0;
+  do {
+    f();
+    iters++;
+    t1 = seconds();
+  } while (t1 - t0 < 0.2);
+  const uint64_t c1 = cycles();
+  const double per_unit = (double)(c1 - c0) / iters / units;
+  const double mbs = (double)bytes * iters / (t1 - t0) / 1e6;
+  printf("%-28s %10.2f %s/%s %10.1f MB/s\n", name, per_unit, cycles_unit, unit,
+         mbs);
+}
+
+int main() {
+  // deterministic inputs from the library generator with a fixed seed
+  myriota_rng rng;
+  myriota_rng_init(&rng, 20200101);
+  const size_t N = 1 << 20;
+  std::vector<uint8_t> buf(N);
+  for (size_t i = 0; i < N; i++) buf[i] = myriota_rng_next(&rng);
+
+  // Resample16, 48000 to 44100 in 64k sample blocks
+  {
+    const size_t n = 1 << 16;
+    std::vector<myriota_complex_16> in(n), out(n);
+    for (size_t i = 0; i < n; i++) {
+      in[i].re = (int16_t)myriota_rng_next(&rng);
+      in[i].im = (int16_t)myriota_rng_next(&rng);
+    }
+    myriota::Resample16 r(48000, 44100);
+    bench("Resample16 48k->44.1k", "sample", n,
+          n * sizeof(myriota_complex_16), [&] {
+            const uint64_t pushed = r.pushed();
+            const myriota_complex_16 *p = in.data();
+            size_t remaining = n;
+            while (remaining > 0) {
+              const size_t nout = r.process(p, remaining, out.data(), n);
+              const size_t used = r.pushed() - pushed - (p - in.data());
+              p += used;
+              remaining -= used;
+              sink += nout;
+              if (used == 0 && nout == 0) break;
+            }
+          });
+  }
+
+  bench("myriota_crc32 1MB", "byte", N, N,
+        [&] { sink += myriota_crc32(buf.data(), N, 0); });
+
+  bench("myriota_sha256 1MB", "byte", N, N, [&] {
+    uint8_t hash[SHA256_BYTES];
+    myriota_sha256(buf.data(), N, hash);
+    sink += hash[0];
+  });
+
+  {
+    // 2^20 - 1 is a multiple of both 3 and 5, as the codecs require
+    const size_t M = N - 1;
+    std::vector<char> s(2 * N + 1);
+    std::vector<uint8_t> back(N);
+    bench("base64 encode 1MB", "byte", M, M,
+          [&] { sink += myriota_buf_to_base64(buf.data(), M, s.data()); });
+    const size_t slen = strlen(s.data());
+    bench("base64 decode 1MB", "byte", M, M, [&] {
+      sink += myriota_n_base64_to_buf(s.data(), slen, back.data());
+    });
+    bench("zbase32 encode 1MB", "byte", M, M,
+          [&] { sink += myriota_buf_to_zbase32(buf.data(), M, s.data()); });
+    const size_t zlen = strlen(s.data());
+    bench("zbase32 decode 1MB", "byte", M, M, [&] {
+      sink += myriota_n_zbase32_to_buf(s.data(), zlen, back.data());
+    });
+  }
+
+  {
+    const size_t n = 1 << 16;
+    std::vector<double> master(n), work(n);
+    for (size_t i = 0; i < n; i++)
+      master[i] = myriota_rng_uniform(&rng) - 0.5;
+    // select mutates its input so each call pays for one copy of the array
+    bench("select_double median 64k", "item", n, n * sizeof(double), [&] {
+      memcpy(work.data(), master.data(), n * sizeof(double));
+      const double m = myriota_select_double(n / 2, work.data(), n);
+      sink += (uint64_t)(m * 1e6);
+    });
+  }
+
+  return 0;
+}
@@ -41,25 +41,9 @@ int main(int argc, char **argv) {
   const std::string output_type = cmd_parser.get<std::string>("to");
   const bool exit_on_clip = cmd_parser.exist("exit-on-clip");
 
-  // assign function to read samples from file
-  bool (*read_sample)(FILE * stdin, complex & sample);
-  if (input_type == "double")
-    read_sample = read_sample_of_type<double>;
-  else if (input_type == "float")
-    read_sample = read_sample_of_type<float>;
-  else if (input_type == "uint8")
-    read_sample = read_sample_of_type<uint8_t>;
-  else if (input_type == "int8")
-    read_sample = read_sample_of_type<int8_t>;
-  else if (input_type == "int16")
-    read_sample = read_sample_of_type<int16_t>;
-  else if (input_type == "uint16")
-    read_sample = read_sample_of_type<uint16_t>;
-  else if (input_type == "int32")
-    read_sample = read_sample_of_type<int32_t>;
-  else if (input_type == "txt")
-    read_sample = read_sample_txt;
-  else {
+  // assign function to read blocks of samples from file
+  const ReadBlockFn read_block = read_block_for(input_type);
+  if (read_block == NULL) {
     std::cerr << "Input type must be one of double, float, uint8, int8, int16, "
                  "uint16, or int32"
               << std::endl;
@@ -67,25 +51,9 @@ int main(int argc, char **argv) {
     return EXIT_FAILURE;
   }
 
-  // assign function to write sample to stdout
-  bool (*print_sample)(FILE *, const complex);
-  if (output_type == "double")
-    print_sample = print_sample_of_type<double>;
-  else if (output_type == "float")
-    print_sample = print_sample_of_type<float>;
-  else if (output_type == "uint8")
-    print_sample = print_sample_of_type<uint8_t>;
-  else if (output_type == "int8")
-    print_sample = print_sample_of_type<int8_t>;
-  else if (output_type == "int16")
-    print_sample = print_sample_of_type<int16_t>;
-  else if (output_type == "uint16")
-    print_sample = print_sample_of_type<uint16_t>;
-  else if (output_type == "int32")
-    print_sample = print_sample_of_type<int32_t>;
-  else if (output_type == "txt")
-    print_sample = print_sample_txt;
-  else {
+  // assign function to write blocks of samples to stdout
+  const PrintBlockFn print_block = print_block_for(output_type);
+  if (print_block == NULL) {
     std::cerr
         << "Output type must be one of double, float, int8, int16, uint16, or "
            "int32"
@@ -94,11 +62,15 @@ int main(int argc, char **argv) {
     return EXIT_FAILURE;
   }
 
-  // the actual conversion loop
-  complex sample;
-  while (read_sample(stdin, sample)) {
-    const bool clipped = print_sample(stdout, sample);
-    if (exit_on_clip && clipped) return EXIT_FAILURE;
+  // the actual conversion loop, a block at a time with large stdio buffers
+  setvbuf(stdin, NULL, _IOFBF, 1 << 20);
+  setvbuf(stdout, NULL, _IOFBF, 1 << 20);
+  std::vector<complex> block(1 << 16);
+  size_t nclipped = 0;
+  size_t n;
+  while ((n = read_block(stdin, block.data(), block.size())) > 0) {
+    print_block(stdout, block.data(), n, nclipped);
+    if (exit_on_clip && nclipped) return EXIT_FAILURE;
   }
 
   return EXIT_SUCCESS;
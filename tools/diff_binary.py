@@ -0,0 +1,342 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# Copyright (c) 2021, Myriota Pty Ltd, All Rights Reserved
+# SPDX-License-Identifier: BSD-3-Clause-Attribution
+#
+# This file is licensed under the BSD with attribution  (the "License"); you
+# may not use these files except in compliance with the License.
+#
+# You may obtain a copy of the License here:
+# LICENSE-BSD-3-Clause-Attribution.txt and at
+# https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+#
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Creates a delta file between two images so an update only transfers and
+# reflashes the regions that changed. Inputs can be raw binaries or merged
+# files assembled by merge_binary.py; merged files are split into their
+# sections and diffed section by section, so a size change in one section
+# does not corrupt the diff of the sections after it. Regions are aligned
+# to the 2048 byte flash page so the apply side only erases changed pages.
+#
+# Delta file layout, all values little endian:
+#   "MYRD" magic, version(1), merged flag(1), section count(2)
+#   per section: type(2), reserved(2), old length(4), new length(4),
+#                old crc32(4), new crc32(4), region count(4)
+#   per region:  offset(4), length(4), data
+# CRCs are standard CRC-32, identical to myriota_crc32 with zero offset;
+# the apply side verifies the old image before erasing anything and the
+# result after patching.
+
+from __future__ import print_function
+import argparse
+import binascii
+import os
+import shutil
+import signal
+import struct
+import sys
+import tempfile
+
+file_types = {
+    1: "system image",
+    2: "user application",
+    3: "network information",
+}
+
+header_length = (
+    16  # header_version(1), reserved(1), type(2), length(4), reserved(6), checksum(2)
+)
+header_version = 0
+
+delta_magic = b"MYRD"
+delta_version = 0
+page_size = 2048
+
+
+def _bytecrc(crc, poly, n):
+    mask = 1 << (n - 1)
+    for i in range(8):
+        if crc & mask:
+            crc = (crc << 1) ^ poly
+        else:
+            crc = crc << 1
+    mask = (1 << n) - 1
+    crc = crc & mask
+    return crc
+
+
+def calc_crc(data):
+    poly = 0x11021
+    bit_size = 16
+    table = [_bytecrc(i << (bit_size - 8), poly, bit_size) for i in range(256)]
+    crc = 0
+    for b in data:
+        crc = table[b ^ ((crc >> 8) & 0xFF)] ^ ((crc << 8) & 0xFF00)
+    return crc
+
+
+def image_crc(data):
+    return binascii.crc32(bytes(data)) & 0xFFFFFFFF
+
+
+def read_sections(filename):
+    """Returns ([(type, data)], merged). A raw binary is a single system
+    image section."""
+    try:
+        with open(filename, "rb") as input_file:
+            content = input_file.read()
+    except IOError:
+        sys.stderr.write("\nCan't open %s\n" % filename)
+        sys.exit(1)
+
+    sections = []
+    offset = 0
+    while offset + header_length <= len(content):
+        ftype = struct.unpack_from("<H", content, offset + 2)[0]
+        if ftype not in file_types:
+            break
+        flen = struct.unpack_from("<I", content, offset + 4)[0]
+        checksum = struct.unpack_from("<H", content, offset + 14)[0]
+        if offset + header_length + flen > len(content):
+            break
+        data = bytearray(content[offset : offset + header_length + flen])
+        data[14] = data[15] = 0
+        if checksum != (calc_crc(data) & 0xFFFF):
+            break
+        sections.append((ftype, content[offset + header_length : offset + header_length + flen]))
+        offset += header_length + flen
+
+    if offset == len(content) and sections:
+        return sections, True
+    return [(1, content)], False
+
+
+def changed_regions(old, new):
+    """Runs of flash pages that differ, as (offset, data) with data from the
+    new image. Pages past the end of the shorter image always differ."""
+    regions = []
+    start = None
+    npages = (max(len(old), len(new)) + page_size - 1) // page_size
+    for page in range(npages):
+        i = page * page_size
+        if old[i : i + page_size] != new[i : i + page_size]:
+            if start is None:
+                start = i
+        elif start is not None:
+            regions.append((start, new[start:i]))
+            start = None
+    if start is not None:
+        regions.append((start, new[start:]))
+    return regions
+
+
+def create_delta(old_filename, new_filename, outfile):
+    old_sections, old_merged = read_sections(old_filename)
+    new_sections, new_merged = read_sections(new_filename)
+    if old_merged != new_merged:
+        sys.stderr.write("Can't diff a merged file against a raw binary\n")
+        sys.exit(1)
+
+    old_by_type = dict(old_sections)
+    outfile.write(delta_magic)
+    outfile.write(struct.pack("<BBH", delta_version, int(new_merged), len(new_sections)))
+    total = 0
+    for ftype, new_data in new_sections:
+        old_data = old_by_type.get(ftype, b"")
+        regions = changed_regions(old_data, new_data)
+        outfile.write(
+            struct.pack(
+                "<HHIIIII",
+                ftype,
+                0,
+                len(old_data),
+                len(new_data),
+                image_crc(old_data),
+                image_crc(new_data),
+                len(regions),
+            )
+        )
+        for offset, data in regions:
+            outfile.write(struct.pack("<II", offset, len(data)))
+            outfile.write(data)
+            total += len(data)
+        carried = sum(len(d) for _, d in regions)
+        print(
+            "%s: %d of %d bytes in %d region(s)"
+            % (file_types.get(ftype), carried, len(new_data), len(regions))
+        )
+    print("Delta carries %d bytes of image data" % total)
+
+
+def read_delta(filename):
+    try:
+        with open(filename, "rb") as input_file:
+            content = input_file.read()
+    except IOError:
+        sys.stderr.write("\nCan't open %s\n" % filename)
+        sys.exit(1)
+
+    if content[0:4] != delta_magic or len(content) < 8:
+        sys.stderr.write("Not a delta file\n")
+        sys.exit(1)
+    version, merged, nsections = struct.unpack_from("<BBH", content, 4)
+    if version != delta_version:
+        sys.stderr.write("Unsupported delta version\n")
+        sys.exit(1)
+
+    sections = []
+    offset = 8
+    for _ in range(nsections):
+        ftype, _, old_len, new_len, old_crc, new_crc, nregions = struct.unpack_from(
+            "<HHIIIII", content, offset
+        )
+        offset += 24
+        regions = []
+        for _ in range(nregions):
+            roffset, rlen = struct.unpack_from("<II", content, offset)
+            offset += 8
+            regions.append((roffset, content[offset : offset + rlen]))
+            offset += rlen
+        sections.append((ftype, old_len, new_len, old_crc, new_crc, regions))
+    if offset != len(content):
+        sys.stderr.write("Delta file is corrupted\n")
+        sys.exit(1)
+    return sections, bool(merged)
+
+
+def append_section(outfile, ftype, data):
+    start = outfile.tell()
+    outfile.write(struct.pack("<BBHII", header_version, 0, ftype, len(data), 0))
+    outfile.write(struct.pack("<HH", 0, 0))
+    outfile.write(data)
+    outfile.seek(start)
+    header = bytearray(outfile.read(header_length + len(data)))
+    checksum = calc_crc(header) & 0xFFFF
+    outfile.seek(start + 14)
+    outfile.write(struct.pack("<H", checksum))
+    outfile.seek(0, os.SEEK_END)
+
+
+def apply_delta(old_filename, delta_filename, outfile):
+    sections, merged = read_delta(delta_filename)
+    old_sections, old_merged = read_sections(old_filename)
+    if merged != old_merged:
+        sys.stderr.write("Delta and image disagree on merged file layout\n")
+        sys.exit(1)
+    old_by_type = dict(old_sections)
+
+    for ftype, old_len, new_len, old_crc, new_crc, regions in sections:
+        old_data = old_by_type.get(ftype, b"")
+        if len(old_data) != old_len or image_crc(old_data) != old_crc:
+            sys.stderr.write(
+                "%s does not match the image this delta was made from\n"
+                % file_types.get(ftype)
+            )
+            sys.exit(1)
+        new_data = bytearray(old_data[:new_len])
+        new_data.extend(b"\x00" * (new_len - len(new_data)))
+        for roffset, rdata in regions:
+            new_data[roffset : roffset + len(rdata)] = rdata
+        if image_crc(new_data) != new_crc:
+            sys.stderr.write(
+                "Failed to verify patched %s\n" % file_types.get(ftype)
+            )
+            sys.exit(1)
+        if merged:
+            append_section(outfile, ftype, bytes(new_data))
+        else:
+            outfile.write(new_data)
+        print("Patched %s, %d bytes" % (file_types.get(ftype), new_len))
+
+
+def list_delta(filename):
+    sections, merged = read_delta(filename)
+    print("List sections from", filename, "\n")
+    for ftype, old_len, new_len, old_crc, new_crc, regions in sections:
+        print("Type   :", file_types.get(ftype))
+        print("Size   :", old_len, "to", new_len, "bytes")
+        print("CRC    : %08x to %08x" % (old_crc, new_crc))
+        print("Carries:", sum(len(d) for _, d in regions), "bytes in", len(regions), "region(s)", "\n")
+
+
+def signal_handler(signal, frame):
+    sys.exit(0)
+
+
+def main():
+    signal.signal(signal.SIGINT, signal_handler)
+    try:
+        signal.signal(signal.SIGPIPE, signal_handler)
+    except AttributeError:
+        pass
+
+    parser = argparse.ArgumentParser(
+        description="Create and apply delta updates between Myriota images",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    parser.add_argument(
+        "-f",
+        "--from_file",
+        dest="old_filename",
+        metavar="FILE",
+        help="image currently on the device",
+    )
+    parser.add_argument(
+        "-t",
+        "--to_file",
+        dest="new_filename",
+        metavar="FILE",
+        help="image to update to",
+    )
+    parser.add_argument(
+        "-a",
+        "--apply",
+        dest="delta_to_apply",
+        metavar="FILE",
+        help="apply a delta file to the image given by -f",
+    )
+    parser.add_argument(
+        "-l",
+        "--list_contents",
+        dest="file_to_list",
+        metavar="FILE",
+        help="list sections in a delta file",
+    )
+    parser.add_argument(
+        "-o",
+        "--output",
+        dest="output_filename",
+        metavar="FILE",
+        help="output delta or patched image file",
+    )
+
+    args = parser.parse_args()
+
+    if args.file_to_list:
+        list_delta(args.file_to_list)
+        return
+
+    if not args.output_filename:
+        sys.stderr.write("Please specify the output filename\n")
+        sys.exit(1)
+
+    output_temp = tempfile.NamedTemporaryFile(mode="w+b")
+    if args.delta_to_apply:
+        if not args.old_filename:
+            sys.stderr.write("Please specify the image to patch with -f\n")
+            sys.exit(1)
+        apply_delta(args.old_filename, args.delta_to_apply, output_temp)
+    elif args.old_filename and args.new_filename:
+        create_delta(args.old_filename, args.new_filename, output_temp)
+    else:
+        sys.stderr.write("Please specify both -f and -t to create a delta\n")
+        sys.exit(1)
+    output_temp.flush()
+    shutil.copyfile(output_temp.name, args.output_filename)
+    output_temp.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,137 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "tools/cmdline.h"
+#include "tools/iqfile.h"
+
+using namespace iqfile;
+
+int main(int argc, char **argv) {
+  cmdline::parser cmd_parser;
+
+  cmd_parser.set_description(
+      "Work with self describing IQ containers (see tools/iqfile.h). With "
+      "--wrap, raw samples from stdin are wrapped into a container. With "
+      "--info, the container header is printed. Otherwise a window of the "
+      "container given by --begin/--duration (seconds, relative to the "
+      "capture start) or --sample/--count is extracted via mmap, so the cost "
+      "is proportional to the window rather than the file. The container "
+      "file is the remaining command line argument.\n");
+  cmd_parser.add("wrap", '\0', "wrap raw samples from stdin into a container");
+  cmd_parser.add("info", '\0', "print the container header");
+  cmd_parser.add<std::string>(
+      "type", 't', "sample type: double, float, uint8, int8, int16, uint16, "
+                   "int32 (with --wrap)",
+      false, "double");
+  cmd_parser.add<double>("rate", 'r', "sample rate in Hz (with --wrap)", false,
+                         0);
+  cmd_parser.add<double>("start-time", '\0',
+                         "capture start, unix seconds (with --wrap)", false, 0);
+  cmd_parser.add<double>("begin", 'b', "window start in seconds", false, 0);
+  cmd_parser.add<double>("duration", 'd', "window length in seconds", false,
+                         -1);
+  cmd_parser.add<long long>("sample", 's', "window start in samples", false,
+                            -1);
+  cmd_parser.add<long long>("count", 'c', "window length in samples", false,
+                            -1);
+  cmd_parser.add("raw", '\0',
+                 "write the extracted window as raw headerless samples");
+  cmd_parser.add<std::string>("output", 'o', "output file, default stdout",
+                              false, "");
+  cmd_parser.parse_check(argc, argv);
+
+  try {
+    const std::string out = cmd_parser.get<std::string>("output");
+
+    if (cmd_parser.exist("wrap")) {
+      const double rate = cmd_parser.get<double>("rate");
+      if (rate <= 0 || out.empty()) {
+        std::cerr << "--wrap requires --rate and --output" << std::endl;
+        return EXIT_FAILURE;
+      }
+      IQWriter w(out, iq_type_from_name(cmd_parser.get<std::string>("type")),
+                 rate, cmd_parser.get<double>("start-time"));
+      const size_t sb = iq_sample_bytes(w.type);
+      std::vector<uint8_t> block((4u << 20) / sb * sb);
+      size_t got;
+      while ((got = fread(block.data(), sb, block.size() / sb, stdin)) > 0)
+        w.write(block.data(), got);
+      w.close();
+      return EXIT_SUCCESS;
+    }
+
+    if (cmd_parser.rest().size() != 1) {
+      std::cerr << "expected one container file argument" << std::endl;
+      std::cerr << cmd_parser.usage();
+      return EXIT_FAILURE;
+    }
+    IQReader in(cmd_parser.rest()[0]);
+
+    if (cmd_parser.exist("info")) {
+      printf("type %s\n", iq_type_name(in.type));
+      printf("rate %.17g\n", in.rate);
+      printf("start_time %.17g\n", in.start_time);
+      printf("samples %llu\n", (unsigned long long)in.nsamples);
+      printf("duration %.6f\n", in.nsamples / in.rate);
+      printf("index_points %zu\n", in.index.size());
+      return EXIT_SUCCESS;
+    }
+
+    // window in samples from either time or sample arguments
+    uint64_t first, count;
+    if (cmd_parser.get<long long>("sample") >= 0) {
+      first = cmd_parser.get<long long>("sample");
+      if (first > in.nsamples) first = in.nsamples;
+      const long long c = cmd_parser.get<long long>("count");
+      count = c < 0 ? in.nsamples - first : (uint64_t)c;
+    } else {
+      first = in.time_to_sample(in.start_time + cmd_parser.get<double>("begin"));
+      const double d = cmd_parser.get<double>("duration");
+      count = d < 0 ? in.nsamples - first : (uint64_t)(d * in.rate);
+    }
+    if (first + count > in.nsamples) count = in.nsamples - first;
+
+    FILE *outfile = stdout;
+    if (!out.empty()) {
+      outfile = fopen(out.c_str(), "wb");
+      if (outfile == NULL) {
+        std::cerr << "cannot create " << out << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    if (!cmd_parser.exist("raw")) {
+      // windowed container, start time advanced to the window
+      uint8_t h[IQ_HEADER_BYTES] = {0};
+      memcpy(h, IQ_MAGIC, sizeof(IQ_MAGIC));
+      memcpy(h + 8, &IQ_VERSION, 4);
+      memcpy(h + 12, &in.type, 4);
+      memcpy(h + 16, &in.rate, 8);
+      const double t0 = in.sample_to_time(first);
+      memcpy(h + 24, &t0, 8);
+      memcpy(h + 32, &count, 8);
+      fwrite(h, 1, sizeof(h), outfile);
+    }
+    fwrite(in.at(first), in.sample_bytes(), count, outfile);
+    if (outfile != stdout) fclose(outfile);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,286 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IQFILE_H
+#define IQFILE_H
+
+// Self describing, seekable container for complex sample captures.
+//
+// Raw headerless files require every tool to be told the rate and type via
+// flags, and random access needs manual byte math. The container stores them
+// once and makes extracting a time window out of a very large capture
+// O(window) rather than O(file):
+//
+// offset size field
+//      0    8 magic "MyriotaQ"
+//      8    4 version, currently 1, little endian uint32
+//     12    4 sample type, IQType below, little endian uint32
+//     16    8 sample rate in Hz, little endian double
+//     24    8 capture start time, unix seconds, 0 if unknown
+//     32    8 number of complex samples, little endian uint64
+//     40    8 byte offset of the time index, 0 if absent
+//     48   16 reserved, zero
+//     64      samples, interleaved re then im, little endian
+//
+// The optional time index trails the samples as a count followed by (sample
+// number, unix seconds) pairs in ascending order, for captures with gaps
+// where time is not an affine function of sample number. IQWriter fills in
+// the sample count and index offset when closed, so a truncated file is
+// detectable by its zero sample count.
+//
+// IQReader maps the file read only with mmap: data() exposes the samples
+// zero copy and extraction or tail seeking only faults in the pages touched.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace iqfile {
+
+static const char IQ_MAGIC[8] = {'M', 'y', 'r', 'i', 'o', 't', 'a', 'Q'};
+static const uint32_t IQ_VERSION = 1;
+static const size_t IQ_HEADER_BYTES = 64;
+
+// matches the type names used by tools/convert_type.cpp
+enum IQType {
+  IQ_DOUBLE = 0,
+  IQ_FLOAT = 1,
+  IQ_INT8 = 2,
+  IQ_UINT8 = 3,
+  IQ_INT16 = 4,
+  IQ_UINT16 = 5,
+  IQ_INT32 = 6,
+};
+
+// bytes per complex sample, i.e. two components
+inline size_t iq_sample_bytes(const uint32_t type) {
+  switch (type) {
+    case IQ_DOUBLE:
+      return 16;
+    case IQ_FLOAT:
+      return 8;
+    case IQ_INT8:
+    case IQ_UINT8:
+      return 2;
+    case IQ_INT16:
+    case IQ_UINT16:
+      return 4;
+    case IQ_INT32:
+      return 8;
+  }
+  throw std::runtime_error("unknown IQ sample type");
+}
+
+inline const char *iq_type_name(const uint32_t type) {
+  static const char *names[] = {"double", "float",  "int8", "uint8",
+                                "int16",  "uint16", "int32"};
+  if (type > IQ_INT32) throw std::runtime_error("unknown IQ sample type");
+  return names[type];
+}
+
+inline uint32_t iq_type_from_name(const std::string &name) {
+  for (uint32_t t = IQ_DOUBLE; t <= IQ_INT32; t++)
+    if (name == iq_type_name(t)) return t;
+  throw std::runtime_error("unknown IQ sample type " + name);
+}
+
+struct IQIndexEntry {
+  uint64_t sample;
+  double time;  // unix seconds
+};
+
+// Streaming writer. Samples are appended with write(); the sample count and
+// optional time index are fixed up when the writer is closed or destroyed.
+class IQWriter {
+ public:
+  IQWriter(const std::string &path, const uint32_t type, const double rate,
+           const double start_time = 0)
+      : type(type), nsamples(0), file(fopen(path.c_str(), "wb")) {
+    if (file == NULL)
+      throw std::runtime_error("cannot create " + path + ": " +
+                               strerror(errno));
+    uint8_t h[IQ_HEADER_BYTES] = {0};
+    memcpy(h, IQ_MAGIC, sizeof(IQ_MAGIC));
+    memcpy(h + 8, &IQ_VERSION, 4);
+    memcpy(h + 12, &type, 4);
+    memcpy(h + 16, &rate, 8);
+    memcpy(h + 24, &start_time, 8);
+    if (fwrite(h, 1, sizeof(h), file) != sizeof(h))
+      throw std::runtime_error("write failed: " + std::string(strerror(errno)));
+  }
+
+  // append n complex samples of the constructed type
+  void write(const void *samples, const size_t n) {
+    if (fwrite(samples, iq_sample_bytes(type), n, file) != n)
+      throw std::runtime_error("write failed: " + std::string(strerror(errno)));
+    nsamples += n;
+  }
+
+  // record that sample number `sample` was captured at `time` unix seconds.
+  // Samples numbers must be added in ascending order.
+  void add_index_point(const uint64_t sample, const double time) {
+    index.push_back((IQIndexEntry){sample, time});
+  }
+
+  // fix up the header and append the index, further writes are invalid
+  void close() {
+    if (file == NULL) return;
+    uint64_t index_offset = 0;
+    if (!index.empty()) {
+      index_offset = IQ_HEADER_BYTES + nsamples * iq_sample_bytes(type);
+      const uint64_t count = index.size();
+      fwrite(&count, 8, 1, file);
+      for (size_t i = 0; i < index.size(); i++) {
+        fwrite(&index[i].sample, 8, 1, file);
+        fwrite(&index[i].time, 8, 1, file);
+      }
+    }
+    if (fseek(file, 32, SEEK_SET) != 0 || fwrite(&nsamples, 8, 1, file) != 1 ||
+        fwrite(&index_offset, 8, 1, file) != 1 || fclose(file) != 0) {
+      file = NULL;
+      throw std::runtime_error("close failed: " + std::string(strerror(errno)));
+    }
+    file = NULL;
+  }
+
+  ~IQWriter() {
+    try {
+      close();
+    } catch (...) {
+    }
+  }
+
+  const uint32_t type;
+  uint64_t nsamples;
+
+ private:
+  IQWriter(const IQWriter &);  // not copyable
+  IQWriter &operator=(const IQWriter &);
+  FILE *file;
+  std::vector<IQIndexEntry> index;
+};
+
+// Memory mapped zero copy reader
+class IQReader {
+ public:
+  IQReader(const std::string &path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("cannot open " + path + ": " + strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < IQ_HEADER_BYTES) {
+      ::close(fd);
+      throw std::runtime_error(path + " is not an IQ container");
+    }
+    bytes = st.st_size;
+    map = (const uint8_t *)mmap(NULL, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping holds its own reference
+    if (map == MAP_FAILED)
+      throw std::runtime_error("mmap failed: " + std::string(strerror(errno)));
+    if (memcmp(map, IQ_MAGIC, sizeof(IQ_MAGIC)) != 0) {
+      munmap((void *)map, bytes);
+      throw std::runtime_error(path + " is not an IQ container");
+    }
+    memcpy(&version, map + 8, 4);
+    memcpy(&type, map + 12, 4);
+    memcpy(&rate, map + 16, 8);
+    memcpy(&start_time, map + 24, 8);
+    memcpy(&nsamples, map + 32, 8);
+    uint64_t index_offset;
+    memcpy(&index_offset, map + 40, 8);
+    const uint64_t expect =
+        IQ_HEADER_BYTES + nsamples * iq_sample_bytes(type);
+    if (version != IQ_VERSION || expect > bytes ||
+        (index_offset != 0 && index_offset + 8 > bytes)) {
+      munmap((void *)map, bytes);
+      throw std::runtime_error(path + " is truncated or unsupported");
+    }
+    if (index_offset != 0) {
+      uint64_t count;
+      memcpy(&count, map + index_offset, 8);
+      if (index_offset + 8 + 16 * count > bytes) {
+        munmap((void *)map, bytes);
+        throw std::runtime_error(path + " has a truncated index");
+      }
+      index.resize(count);
+      for (uint64_t i = 0; i < count; i++) {
+        memcpy(&index[i].sample, map + index_offset + 8 + 16 * i, 8);
+        memcpy(&index[i].time, map + index_offset + 16 + 16 * i, 8);
+      }
+    }
+  }
+
+  // zero copy pointer to the first sample
+  const void *data() const { return map + IQ_HEADER_BYTES; }
+
+  // zero copy pointer to sample n
+  const void *at(const uint64_t n) const {
+    return map + IQ_HEADER_BYTES + n * iq_sample_bytes(type);
+  }
+
+  size_t sample_bytes() const { return iq_sample_bytes(type); }
+
+  // unix time of sample n, from the index when present, otherwise affine in
+  // the rate and start time
+  double sample_to_time(const uint64_t n) const {
+    if (index.empty()) return start_time + n / rate;
+    // interpolate from the last index point at or before n
+    size_t i = index.size() - 1;
+    while (i > 0 && index[i].sample > n) i--;
+    return index[i].time + ((double)n - (double)index[i].sample) / rate;
+  }
+
+  // the first sample at or after unix time t, clipped to [0, nsamples]
+  uint64_t time_to_sample(const double t) const {
+    double t0 = start_time;
+    uint64_t n0 = 0;
+    if (!index.empty()) {
+      size_t i = index.size() - 1;
+      while (i > 0 && index[i].time > t) i--;
+      t0 = index[i].time;
+      n0 = index[i].sample;
+    }
+    const double n = n0 + (t - t0) * rate;
+    if (n <= 0) return 0;
+    if (n >= (double)nsamples) return nsamples;
+    return (uint64_t)ceil(n);
+  }
+
+  ~IQReader() { munmap((void *)map, bytes); }
+
+  uint32_t version;
+  uint32_t type;
+  double rate;
+  double start_time;
+  uint64_t nsamples;
+  std::vector<IQIndexEntry> index;
+
+ private:
+  IQReader(const IQReader &);  // not copyable
+  IQReader &operator=(const IQReader &);
+  const uint8_t *map;
+  size_t bytes;
+};
+
+}  // namespace iqfile
+
+#endif
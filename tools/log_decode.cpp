@@ -0,0 +1,233 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "tools/cmdline.h"
+#include "tools/log_decode.h"
+
+using namespace logdecode;
+
+// Append only output buffer flushed in large writes. Records are formatted
+// with hand rolled integer and hex appends rather than printf, which is the
+// difference between tens and hundreds of MB/s on log heavy streams.
+class OutBuf {
+ public:
+  OutBuf(FILE *file) : file(file), buf(1 << 20), n(0) {}
+  ~OutBuf() { flush(); }
+  // Make room for a record's worst case. The appends below are unchecked,
+  // so call this once per record rather than bounds checking every byte.
+  inline void ensure(const size_t len) {
+    if (n + len > buf.size()) {
+      flush();
+      if (len > buf.size()) buf.resize(len);
+    }
+  }
+  inline void put(const char c) { buf[n++] = c; }
+  inline void put(const char *s, const size_t len) {
+    memcpy(&buf[n], s, len);
+    n += len;
+  }
+  inline void put_str(const char *s) { put(s, strlen(s)); }
+  inline void put_u64(uint64_t v) {
+    // two digits per division, the divisions dominate record formatting
+    static const char pairs[] =
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+    char tmp[20];
+    int i = 20;
+    while (v >= 100) {
+      i -= 2;
+      memcpy(tmp + i, pairs + 2 * (v % 100), 2);
+      v /= 100;
+    }
+    if (v >= 10) {
+      i -= 2;
+      memcpy(tmp + i, pairs + 2 * v, 2);
+    } else {
+      tmp[--i] = '0' + v;
+    }
+    put(tmp + i, 20 - i);
+  }
+  inline void put_hex(const uint8_t *p, const size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    for (size_t i = 0; i < len; i++) {
+      put(digits[p[i] >> 4]);
+      put(digits[p[i] & 0xf]);
+    }
+  }
+  void flush() {
+    if (n) fwrite(buf.data(), 1, n, file);
+    n = 0;
+  }
+
+ private:
+  FILE *file;
+  std::vector<char> buf;
+  size_t n;
+};
+
+// one field value from a payload known to be large enough
+static inline uint64_t field_value(const uint8_t *p, const char f,
+                                   size_t &off) {
+  uint64_t v = 0;
+  const size_t bytes = f == 'H' ? 2 : f == 'Q' ? 8 : 4;
+  memcpy(&v, p + off, bytes);
+  off += bytes;
+  return v;
+}
+
+// csv: timestamp,code,name,values... with unknown payloads as a hex column.
+// json: one object per line with named fields.
+static void emit_csv(OutBuf &out, const LogEntry &e) {
+  const LogDescriptor *d = log_descriptor(e.code);
+  out.ensure(512 + 2 * (size_t)e.length);
+  out.put_u64(e.timestamp);
+  out.put(',');
+  out.put_u64(e.code);
+  out.put(',');
+  if (d != NULL)
+    out.put_str(d->name);
+  else if (e.code >= 0x80 && e.code <= 0x17f)
+    out.put_str("User error code");
+  else
+    out.put_str("Unknown error code");
+  if (d != NULL && e.length == fmt_bytes(d->fmt)) {
+    size_t off = 0;
+    for (const char *f = d->fmt; *f; f++) {
+      out.put(',');
+      out.put_u64(field_value(e.payload, *f, off));
+    }
+  } else if (e.length > 0) {
+    out.put(',');
+    out.put_hex(e.payload, e.length);
+  }
+  out.put('\n');
+}
+
+static void emit_json(OutBuf &out, const LogEntry &e) {
+  const LogDescriptor *d = log_descriptor(e.code);
+  out.ensure(1024 + 2 * (size_t)e.length);
+  out.put_str("{\"timestamp\":");
+  out.put_u64(e.timestamp);
+  out.put_str(",\"code\":");
+  out.put_u64(e.code);
+  out.put_str(",\"name\":\"");
+  if (d != NULL)
+    out.put_str(d->name);
+  else if (e.code >= 0x80 && e.code <= 0x17f)
+    out.put_str("User error code");
+  else
+    out.put_str("Unknown error code");
+  out.put('"');
+  if (d != NULL && e.length == fmt_bytes(d->fmt)) {
+    size_t off = 0;
+    const char *const *name = d->fields;
+    for (const char *f = d->fmt; *f; f++, name++) {
+      out.put_str(",\"");
+      out.put_str(*name);
+      out.put_str("\":");
+      out.put_u64(field_value(e.payload, *f, off));
+    }
+  } else if (e.length > 0) {
+    out.put_str(",\"payload\":\"");
+    out.put_hex(e.payload, e.length);
+    out.put('"');
+  }
+  out.put_str("}\n");
+}
+
+int main(int argc, char **argv) {
+  cmdline::parser cmd_parser;
+
+  cmd_parser.set_description(
+      "Decodes binary device logs written by LogAdd (see tools/log_decode.h "
+      "for the format) to csv, one record per line: timestamp, code, name, "
+      "then the decoded values, or the raw payload in hex for unknown codes. "
+      "Input is a log file argument or stdin, so multi GB fleet log volumes "
+      "stream at IO speed. Decoding stops at the end of log marker.\n");
+  cmd_parser.add("json", 'j', "one json object per line instead of csv");
+  cmd_parser.add<std::string>("output", 'o', "output file, default stdout",
+                              false, "");
+  cmd_parser.parse_check(argc, argv);
+
+  FILE *infile = stdin;
+  if (cmd_parser.rest().size() == 1) {
+    infile = fopen(cmd_parser.rest()[0].c_str(), "rb");
+    if (infile == NULL) {
+      std::cerr << "cannot open " << cmd_parser.rest()[0] << std::endl;
+      return EXIT_FAILURE;
+    }
+  } else if (cmd_parser.rest().size() > 1) {
+    std::cerr << "expected at most one log file argument" << std::endl;
+    return EXIT_FAILURE;
+  }
+  FILE *outfile = stdout;
+  const std::string out = cmd_parser.get<std::string>("output");
+  if (!out.empty()) {
+    outfile = fopen(out.c_str(), "wb");
+    if (outfile == NULL) {
+      std::cerr << "cannot create " << out << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  const bool json = cmd_parser.exist("json");
+
+  OutBuf ob(outfile);
+  std::vector<uint8_t> buf(4 << 20);
+  size_t have = 0;
+  bool end = false;
+  while (!end) {
+    const size_t got =
+        fread(buf.data() + have, 1, buf.size() - have, infile);
+    have += got;
+    size_t pos = 0;
+    while (true) {
+      LogEntry e;
+      size_t used = 0;
+      const FrameResult r = frame(buf.data() + pos, have - pos, e, used);
+      if (r == FRAME_END) {
+        end = true;
+        break;
+      }
+      if (r == FRAME_NEED_MORE) {
+        if (got == 0) {  // eof with a partial record
+          if (have - pos > 0)
+            fprintf(stderr, "incomplete log entry, %zu trailing bytes\n",
+                    have - pos);
+          end = true;
+        }
+        break;
+      }
+      if (json)
+        emit_json(ob, e);
+      else
+        emit_csv(ob, e);
+      pos += used;
+    }
+    // carry the partial record to the front of the buffer
+    memmove(buf.data(), buf.data() + pos, have - pos);
+    have -= pos;
+  }
+  ob.flush();
+  if (outfile != stdout) fclose(outfile);
+  if (infile != stdin) fclose(infile);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LOG_DECODE_H
+#define LOG_DECODE_H
+
+// Streaming decoder for on device logs written by LogAdd (see
+// module/include/myriota_user_api.h). The format, little endian, matches
+// tools/log-util.py:
+//
+//   |0-3 timestamp|4-5 length|6-7 code|payload, length bytes padded to 4|
+//
+// A timestamp of 0xffffffff (erased flash) marks the end of the log.
+//
+// frame() is zero copy: the returned entry points into the caller's buffer,
+// so a reader hands in successive file blocks and only the partial entry at
+// a block boundary is ever carried over. Known system codes decode to named
+// fields through log_descriptor(); codes 0x80 to 0x17f are user error
+// codes and everything else, including payloads whose length does not match
+// the descriptor, is passed through as raw bytes.
+
+#include <stdint.h>
+#include <string.h>
+
+namespace logdecode {
+
+struct LogEntry {
+  uint32_t timestamp;
+  uint16_t length;  // payload bytes, excluding padding
+  uint16_t code;
+  const uint8_t *payload;  // into the caller's buffer, not a copy
+};
+
+enum FrameResult {
+  FRAME_ENTRY,      // entry holds the next record
+  FRAME_NEED_MORE,  // a partial record remains, supply more input
+  FRAME_END,        // end of log marker
+};
+
+// frame the next entry from buf[0..n), advancing used by the bytes consumed
+inline FrameResult frame(const uint8_t *buf, const size_t n, LogEntry &entry,
+                         size_t &used) {
+  if (n < 8) return FRAME_NEED_MORE;
+  memcpy(&entry.timestamp, buf, 4);
+  if (entry.timestamp == 0xffffffff) return FRAME_END;
+  memcpy(&entry.length, buf + 4, 2);
+  memcpy(&entry.code, buf + 6, 2);
+  const size_t padded = ((size_t)entry.length + 3) / 4 * 4;
+  if (n < 8 + padded) return FRAME_NEED_MORE;
+  entry.payload = buf + 8;
+  used = 8 + padded;
+  return FRAME_ENTRY;
+}
+
+// Field layout of a known code: fmt is one character per field, I for
+// uint32, H for uint16 and Q for uint64, fields are the matching names
+struct LogDescriptor {
+  uint16_t code;
+  const char *name;
+  const char *fmt;
+  const char *const *fields;
+};
+
+// the code tables of tools/log-util.py
+namespace tables {
+static const char *const internal_test[] = {"Test1", "Test2"};
+static const char *const watchdog_reset[] = {"Job ID", "PC", "LR"};
+static const char *const system_states[] = {
+    "Reset reason",          "Wakeup times",
+    "Last GNSS fix time",    "Last job ID",
+    "Watchdog timeouted job ID", "Watchdog timeout address",
+    "Job ID of maximum run count", "Last log ID",
+    "GNSS fix failures",     "GNSS fix successes",
+    "GNSS total fix time",   "Job maximum run count"};
+static const char *const mcu_faults[] = {"CFSR", "LR", "PC", "PSR"};
+static const char *const application_starts[] = {"Build hash", "SDK version"};
+static const char *const assertion_failure[] = {"Return address",
+                                                "Line number"};
+static const char *const stack_low[] = {"JobId", "StackUsage"};
+static const char *const stack_overflow[] = {"JobId"};
+static const char *const module_id[] = {"Module ID"};
+static const char *const reset_reason[] = {"Reset reason"};
+static const char *const periodic_states[] = {
+    "Reset reason",        "Wakeup count",
+    "Last GNSS fix time",  "GNSS total fix time",
+    "GNSS fix failures",   "GNSS fix successes",
+    "Last job ID",         "Job ID of maximum run count",
+    "Job maximum run count", "User jobs run count",
+    "Last log ID"};
+static const char *const comm_stats[] = {"Timestamp", "RX attempt",
+                                         "RX success", "RX unverified",
+                                         "TX attempt"};
+}  // namespace tables
+
+static const LogDescriptor log_descriptors[] = {
+    {0, "Internal test", "II", tables::internal_test},
+    {1, "Factory reset", "", NULL},
+    {2, "Watchdog reset", "III", tables::watchdog_reset},
+    {3, "System states", "IIIIIIIIIIII", tables::system_states},
+    {4, "MCU faults", "IIII", tables::mcu_faults},
+    {5, "Invalid key", "", NULL},
+    {6, "Application starts", "QI", tables::application_starts},
+    {7, "Assertion failure", "II", tables::assertion_failure},
+    {8, "Memory error", "", NULL},
+    {9, "Stack low in space", "II", tables::stack_low},
+    {10, "Stack overflow", "I", tables::stack_overflow},
+    {11, "Module ID", "I", tables::module_id},
+    {12, "Reset reason", "I", tables::reset_reason},
+    {13, "Periodic states dump", "IIIIIIIIIII", tables::periodic_states},
+    {14, "Suspend mode enable", "", NULL},
+    {15, "Suspend mode disable", "", NULL},
+    {383, "Satellite communication stats", "IHHHH", tables::comm_stats},
+};
+
+// bytes described by a field format
+inline size_t fmt_bytes(const char *fmt) {
+  size_t n = 0;
+  for (; *fmt; fmt++) n += *fmt == 'H' ? 2 : *fmt == 'Q' ? 8 : 4;
+  return n;
+}
+
+// the descriptor for a code, NULL if unknown. The system codes are dense
+// from zero so the lookup on the per record path is an index
+inline const LogDescriptor *log_descriptor(const uint16_t code) {
+  if (code < 16) return &log_descriptors[code];
+  if (code == 383) return &log_descriptors[16];
+  return NULL;
+}
+
+}  // namespace logdecode
+
+#endif
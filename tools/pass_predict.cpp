@@ -0,0 +1,141 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "tools/cmdline.h"
+#include "tools/pass_predict.h"
+
+using namespace passpredict;
+
+static FILE *open_or_die(const std::string &path, const char *mode) {
+  FILE *f = fopen(path.c_str(), mode);
+  if (f == NULL)
+    throw std::runtime_error("cannot open " + path);
+  return f;
+}
+
+int main(int argc, char **argv) {
+  cmdline::parser cmd_parser;
+
+  cmd_parser.set_description(
+      "Predicts satellite passes for many devices against many satellites in "
+      "one process (see tools/pass_predict.h). Satellites are one per line: "
+      "name, semi major axis in km, eccentricity, inclination, right "
+      "ascension of the node, argument of perigee and mean anomaly in "
+      "degrees, and element epoch in unix seconds. Devices are one per line: "
+      "latitude and longitude in degrees, indexed by line number. Output "
+      "records are 40 bytes: device and satellite index as uint32, then "
+      "rise, set and peak time in unix seconds and peak elevation in degrees "
+      "as doubles, ordered by device, satellite, rise.\n");
+  cmd_parser.add<std::string>("satellites", 's', "satellite element file",
+                              true);
+  cmd_parser.add<std::string>("devices", 'd', "device position file", true);
+  cmd_parser.add<double>("begin", 'b', "horizon start, unix seconds, 0 = now",
+                         false, 0);
+  cmd_parser.add<double>("duration", 'l', "horizon length in seconds", false,
+                         7 * 86400.0);
+  cmd_parser.add<double>("min-elevation", 'e',
+                         "pass threshold elevation in degrees", false, 15);
+  cmd_parser.add<double>("step", '\0',
+                         "detection grid step in seconds, refined passes are "
+                         "solver accurate regardless",
+                         false, 30);
+  cmd_parser.add<int>("threads", '\0', "worker threads over device ranges",
+                      false, 1);
+  cmd_parser.add("text", '\0', "write readable text instead of binary");
+  cmd_parser.add<std::string>("output", 'o', "output file, default stdout",
+                              false, "");
+  cmd_parser.parse_check(argc, argv);
+
+  try {
+    std::vector<Elements> sats;
+    {
+      FILE *f = open_or_die(cmd_parser.get<std::string>("satellites"), "r");
+      char line[512];
+      while (fgets(line, sizeof(line), f) != NULL) {
+        Elements el;
+        if (parse_elements(line, el)) sats.push_back(el);
+      }
+      fclose(f);
+    }
+    std::vector<Device> devs;
+    {
+      FILE *f = open_or_die(cmd_parser.get<std::string>("devices"), "r");
+      double lat, lon;
+      while (fscanf(f, " %lf %lf", &lat, &lon) == 2)
+        devs.push_back(make_device(lat, lon));
+      fclose(f);
+    }
+    if (sats.empty() || devs.empty())
+      throw std::runtime_error("no satellites or no devices");
+
+    double t0 = cmd_parser.get<double>("begin");
+    if (t0 == 0) t0 = time(NULL);
+    const double step = cmd_parser.get<double>("step");
+    const double el_min =
+        degrees_to_radians(cmd_parser.get<double>("min-elevation"));
+    const size_t npoints = cmd_parser.get<double>("duration") / step + 1;
+
+    // satellite positions on the detection grid, computed once and shared
+    // by every device
+    std::vector<std::vector<Vec3>> grid(sats.size());
+    for (size_t s = 0; s < sats.size(); s++) {
+      grid[s].resize(npoints);
+      for (size_t k = 0; k < npoints; k++)
+        grid[s][k] = position(sats[s], t0 + k * step);
+    }
+
+    // partition devices over worker threads, outputs concatenate in order
+    const int threads = std::max(1, cmd_parser.get<int>("threads"));
+    std::vector<std::future<std::vector<Pass>>> work;
+    for (int w = 0; w < threads; w++) {
+      const size_t first = devs.size() * w / threads;
+      const size_t last = devs.size() * (w + 1) / threads;
+      work.push_back(std::async(std::launch::async, [&, first, last]() {
+        std::vector<Pass> out;
+        predict(sats, devs, first, last, grid, t0, step, el_min, out);
+        return out;
+      }));
+    }
+
+    FILE *outfile = stdout;
+    const std::string out = cmd_parser.get<std::string>("output");
+    if (!out.empty()) outfile = open_or_die(out, "wb");
+    const bool text = cmd_parser.exist("text");
+    for (int w = 0; w < threads; w++) {
+      const std::vector<Pass> passes = work[w].get();
+      if (text) {
+        for (size_t i = 0; i < passes.size(); i++) {
+          const Pass &p = passes[i];
+          fprintf(outfile, "%u %s %.3f %.3f %.3f %.2f\n", p.device,
+                  sats[p.satellite].name.c_str(), p.rise, p.set, p.max_time,
+                  p.max_elevation);
+        }
+      } else if (!passes.empty()) {
+        fwrite(passes.data(), sizeof(Pass), passes.size(), outfile);
+      }
+    }
+    if (outfile != stdout) fclose(outfile);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,239 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PASS_PREDICT_H
+#define PASS_PREDICT_H
+
+// Bulk satellite pass prediction: many ground devices against many
+// satellites in one process.
+//
+// Satellites are Keplerian orbital elements with J2 secular perturbation of
+// the node, perigee and mean motion, adequate for planning windows over a
+// week of LEO propagation. Device positions are WGS84 geodetic. A pass is an
+// interval where the elevation of a satellite seen from a device exceeds a
+// threshold.
+//
+// The satellite positions on a coarse time grid are computed once and shared
+// by every device, so the per device per satellite cost is a few arithmetic
+// operations per grid point plus a handful of full propagations to refine
+// each detected pass: rise and set are polished with myriota_brent_root and
+// the peak elevation with myriota_brent_minimise. Passes shorter than the
+// grid step that also peak below the threshold between grid points can be
+// missed, keep the step comfortably below the shortest pass of interest.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "math/myriotamath.h"
+
+namespace passpredict {
+
+// WGS84 and IERS constants
+static const double wgs84_a = 6378137.0;            // equatorial radius, m
+static const double wgs84_e2 = 6.69437999014e-3;    // eccentricity squared
+static const double earth_mu = 3.986004418e14;      // GM, m^3/s^2
+static const double earth_j2 = 1.08262668e-3;       // oblateness harmonic
+
+struct Vec3 {
+  double x, y, z;
+};
+
+static inline Vec3 sub(const Vec3 a, const Vec3 b) {
+  return (Vec3){a.x - b.x, a.y - b.y, a.z - b.z};
+}
+static inline double dot(const Vec3 a, const Vec3 b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+static inline double norm(const Vec3 a) { return sqrt(dot(a, a)); }
+
+// Keplerian elements, angles in radians, semi major axis in metres, epoch
+// in unix seconds
+struct Elements {
+  std::string name;
+  double a, e, i, raan, argp, M0, epoch;
+};
+
+// parse "name a_km e i raan argp M0 epoch" with angles in degrees, returns
+// false for blank and comment lines, throws on malformed lines
+inline bool parse_elements(const char *line, Elements &el) {
+  char name[64];
+  double a_km;
+  if (sscanf(line, " %63s", name) != 1 || name[0] == '#') return false;
+  if (sscanf(line, " %63s %lf %lf %lf %lf %lf %lf %lf", name, &a_km, &el.e,
+             &el.i, &el.raan, &el.argp, &el.M0, &el.epoch) != 8)
+    throw std::runtime_error("malformed satellite line: " + std::string(line));
+  el.name = name;
+  el.a = a_km * 1000;
+  el.i = degrees_to_radians(el.i);
+  el.raan = degrees_to_radians(el.raan);
+  el.argp = degrees_to_radians(el.argp);
+  el.M0 = degrees_to_radians(el.M0);
+  return true;
+}
+
+// earth rotation angle at unix time t, radians
+inline double earth_rotation_angle(const double t) {
+  const double du = (t - 946728000.0) / 86400.0;  // days since J2000 UT
+  return 2 * pi * (0.7790572732640 + 1.00273781191135448 * du);
+}
+
+// ECEF position of a satellite at unix time t. Two body propagation of the
+// elements with J2 secular drift of the node, perigee and mean anomaly,
+// then rotation by the earth rotation angle.
+inline Vec3 position(const Elements &s, const double t) {
+  const double dt = t - s.epoch;
+  const double n = sqrt(earth_mu / (s.a * s.a * s.a));
+  const double p = s.a * (1 - s.e * s.e);
+  const double j2f = 1.5 * earth_j2 * (wgs84_a / p) * (wgs84_a / p) * n;
+  const double ci = cos(s.i);
+  const double raan = s.raan - j2f * ci * dt;
+  const double argp = s.argp + 0.5 * j2f * (5 * ci * ci - 1) * dt;
+  const double nbar =
+      n * (1 + 0.5 * j2f / n * sqrt(1 - s.e * s.e) * (2 - 3 * (1 - ci * ci)));
+  const double M = myriota_mod_2pi(s.M0 + nbar * dt);
+  // Kepler's equation by Newton iteration
+  double E = M;
+  for (int k = 0; k < 12; k++)
+    E -= (E - s.e * sin(E) - M) / (1 - s.e * cos(E));
+  const double r = s.a * (1 - s.e * cos(E));
+  const double nu =
+      2 * atan2(sqrt(1 + s.e) * sin(E / 2), sqrt(1 - s.e) * cos(E / 2));
+  // perifocal to ECI
+  const double u = argp + nu;
+  const double cu = cos(u), su = sin(u);
+  const double co = cos(raan), so = sin(raan);
+  const double si = sin(s.i);
+  const Vec3 eci = {r * (co * cu - so * su * ci), r * (so * cu + co * su * ci),
+                    r * (su * si)};
+  // ECI to ECEF
+  const double th = earth_rotation_angle(t);
+  const double ct = cos(th), st = sin(th);
+  return (Vec3){ct * eci.x + st * eci.y, -st * eci.x + ct * eci.y, eci.z};
+}
+
+// a ground device, geodetic position and precomputed ECEF location and
+// local vertical
+struct Device {
+  double lat, lon;  // radians
+  Vec3 r, up;
+};
+
+inline Device make_device(const double lat_deg, const double lon_deg) {
+  Device d;
+  d.lat = degrees_to_radians(lat_deg);
+  d.lon = degrees_to_radians(lon_deg);
+  const double sp = sin(d.lat), cp = cos(d.lat);
+  const double sl = sin(d.lon), cl = cos(d.lon);
+  const double N = wgs84_a / sqrt(1 - wgs84_e2 * sp * sp);
+  d.r = (Vec3){N * cp * cl, N * cp * sl, N * (1 - wgs84_e2) * sp};
+  d.up = (Vec3){cp * cl, cp * sl, sp};
+  return d;
+}
+
+// elevation of satellite s seen from device d at unix time t, radians
+inline double elevation(const Elements &s, const Device &d, const double t) {
+  const Vec3 delta = sub(position(s, t), d.r);
+  return asin(dot(d.up, delta) / norm(delta));
+}
+
+// one predicted pass; times in unix seconds, elevation in degrees. This is
+// also the binary output record of the pass_predict tool, packed little
+// endian, 40 bytes.
+struct Pass {
+  uint32_t device;     // index into the device list
+  uint32_t satellite;  // index into the satellite list
+  double rise, set;    // threshold crossings, clamped to the horizon ends
+  double max_time;
+  double max_elevation;
+};
+
+// callback data for the solver refinements
+struct ElevationContext {
+  const Elements *s;
+  const Device *d;
+  double el_min;
+};
+
+inline double elevation_residual(double t, void *v) {
+  const ElevationContext *c = (const ElevationContext *)v;
+  return elevation(*c->s, *c->d, t) - c->el_min;
+}
+
+inline double negative_elevation(double t, void *v) {
+  const ElevationContext *c = (const ElevationContext *)v;
+  return -elevation(*c->s, *c->d, t);
+}
+
+// Predict the passes of every satellite over devices [first, last) between
+// t0 and t0 + (grid[s].size() - 1)*step, appending to out in device,
+// satellite, rise order. grid[s][k] is position(sats[s], t0 + k*step),
+// computed once by the caller and shared across devices. el_min in radians.
+inline void predict(const std::vector<Elements> &sats,
+                    const std::vector<Device> &devs, const size_t first,
+                    const size_t last,
+                    const std::vector<std::vector<Vec3>> &grid,
+                    const double t0, const double step, const double el_min,
+                    std::vector<Pass> &out) {
+  const double sin_el = sin(el_min);
+  for (size_t di = first; di < last; di++) {
+    const Device &d = devs[di];
+    for (size_t si = 0; si < sats.size(); si++) {
+      const std::vector<Vec3> &g = grid[si];
+      ElevationContext c = {&sats[si], &d, el_min};
+      // above the threshold iff up.delta > sin(el_min)*|delta|, evaluated
+      // without trigonometry in the grid scan
+      bool above = false;
+      size_t k0 = 0;
+      for (size_t k = 0; k <= g.size(); k++) {
+        bool a = false;
+        if (k < g.size()) {
+          const Vec3 delta = sub(g[k], d.r);
+          a = dot(d.up, delta) > sin_el * norm(delta);
+        }
+        if (a && !above) {
+          k0 = k;
+        } else if (!a && above) {
+          // pass spanning grid points [k0, k), refine the edges with the
+          // solver against the continuous elevation
+          Pass pass;
+          pass.device = di;
+          pass.satellite = si;
+          pass.rise = k0 == 0 ? t0
+                              : myriota_brent_root(elevation_residual, &c,
+                                                   t0 + (k0 - 1) * step,
+                                                   t0 + k0 * step, 1e-3, 100);
+          pass.set = k == g.size()
+                         ? t0 + (g.size() - 1) * step
+                         : myriota_brent_root(elevation_residual, &c,
+                                              t0 + (k - 1) * step,
+                                              t0 + k * step, 1e-3, 100);
+          pass.max_time = myriota_brent_minimise(negative_elevation, &c,
+                                                 pass.rise, pass.set, 1e-2,
+                                                 100);
+          pass.max_elevation =
+              radians_to_degrees(elevation(sats[si], d, pass.max_time));
+          out.push_back(pass);
+        }
+        above = a;
+      }
+    }
+  }
+}
+
+}  // namespace passpredict
+
+#endif
@@ -15,6 +15,10 @@
 #include <stdlib.h>
 #include <complex>
 #include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
 #include "math/myriotamath.h"
 #include "tools/cmdline.h"
 
@@ -22,17 +26,104 @@ using namespace myriota;
 
 template <class R, class C>
 void resample(FILE *infile, R &r) {
-  for (int64_t n = 0; n >= 0; n++) {
-    while (r.maxn() < n) {
-      C x;
-      if (fread(&x, sizeof(C), 1, infile) != 1) return;
-      r.push(x);
+  // read, process and write in 4MB blocks so throughput is bound by the
+  // resampler arithmetic rather than per sample stdio calls
+  const size_t N = (4u << 20) / sizeof(C);
+  std::vector<C> in(N), out(N);
+  while (true) {
+    const size_t nin = fread(in.data(), sizeof(C), N, infile);
+    if (nin == 0) return;
+    const C *p = in.data();
+    size_t remaining = nin;
+    while (remaining > 0) {
+      const uint64_t pushed = r.pushed();
+      const size_t nout = r.process(p, remaining, out.data(), N);
+      const size_t used = r.pushed() - pushed;
+      p += used;
+      remaining -= used;
+      if (nout) fwrite(out.data(), sizeof(C), nout, stdout);
+      if (used == 0 && nout == 0) return;  // neither consuming nor producing
     }
-    const C rn = r(n);
-    fwrite(&rn, sizeof(C), 1, stdout);
   }
 }
 
+// Resample one chunk of input on its own resampler instance (taps are shared
+// through the process wide cache) and return the outputs, dropping the first
+// `first` warm up outputs that belong to the preceding chunk. A negative
+// `count` keeps everything to the end of the stream, otherwise the output is
+// truncated to count samples.
+template <class R, class C>
+std::vector<C> resample_chunk(const double in_rate, const double out_rate,
+                              const double W,
+                              std::shared_ptr<std::vector<C>> in,
+                              const int64_t first, const int64_t count) {
+  R r(in_rate, out_rate, W);
+  std::vector<C> out, tmp(1 << 16);
+  const C *p = in->data();
+  size_t remaining = in->size();
+  while (remaining > 0) {
+    const uint64_t pushed = r.pushed();
+    const size_t nout = r.process(p, remaining, tmp.data(), tmp.size());
+    const size_t used = r.pushed() - pushed;
+    p += used;
+    remaining -= used;
+    out.insert(out.end(), tmp.begin(), tmp.begin() + nout);
+    if (used == 0 && nout == 0) break;
+  }
+  if (first > 0)
+    out.erase(out.begin(),
+              out.begin() + (first < (int64_t)out.size() ? first : out.size()));
+  if (count >= 0 && (int64_t)out.size() > count) out.resize(count);
+  return out;
+}
+
+// Partition the input into chunks overlapping by enough samples to cover the
+// filter window each side and resample them on worker threads, stitching
+// outputs in order. Chunk boundaries are kept at multiples of the rational
+// denominator q so every chunk sees the same polyphase alignment as the
+// streaming path and the stitched output is bit identical to it.
+template <class R, class C>
+void resample_threads(FILE *infile, const double in_rate,
+                      const double out_rate, const double W,
+                      const int threads) {
+  const R probe(in_rate, out_rate, W);
+  const long long p = probe.r.p, q = probe.r.q;
+  const long long B = q * ((long long)ceil(W / probe.kappa) / q + 3);
+  long long L = (long long)((4u << 20) / sizeof(C)) / q * q;
+  if (L < 2 * B) L = 2 * B;
+  std::deque<std::future<std::vector<C>>> pending;
+  const auto drain = [&pending]() {
+    const std::vector<C> v = pending.front().get();
+    pending.pop_front();
+    if (!v.empty()) fwrite(v.data(), sizeof(C), v.size(), stdout);
+  };
+  std::vector<C> carry;  // input read so far for the next chunk
+  bool eof = false;
+  for (long long k = 0; !eof; k++) {
+    const long long s = k == 0 ? 0 : k * L - B;  // chunk input span [s, e)
+    const long long e = (k + 1) * L + B;
+    const size_t have = carry.size();
+    const size_t want = (size_t)(e - s);
+    if (have < want) {
+      carry.resize(want);
+      const size_t got =
+          fread(carry.data() + have, sizeof(C), want - have, infile);
+      carry.resize(have + got);
+      eof = have + got < want;
+    }
+    if (carry.empty()) break;
+    auto in = std::make_shared<std::vector<C>>(carry);
+    const int64_t first = k == 0 ? 0 : B * p / q;
+    const int64_t count = eof ? -1 : L * p / q;
+    if ((int)pending.size() >= threads) drain();
+    pending.push_back(std::async(std::launch::async, resample_chunk<R, C>,
+                                 in_rate, out_rate, W, in, first, count));
+    // keep the trailing 2B samples, the overlap for the next chunk
+    if (!eof) carry.erase(carry.begin(), carry.begin() + ((k + 1) * L - B - s));
+  }
+  while (!pending.empty()) drain();
+}
+
 int main(int argc, char **argv) {
   cmdline::parser cmd_parser;
 
@@ -47,6 +138,16 @@ int main(int argc, char **argv) {
                  "Replace division with shift, only with --int16 option.");
   cmd_parser.add<std::string>("taps", '\0',
                               "print filter taps in verilog format.", false);
+  cmd_parser.add<int>("threads", '\0',
+                      "resample overlapping chunks on this many worker "
+                      "threads, output is identical to single threaded mode.",
+                      false, 1);
+  cmd_parser.add<std::string>(
+      "tap-cache", '\0',
+      "directory of persistent --int16 filter taps, loaded when present and "
+      "written after computation so repeated invocations skip the tap "
+      "computation.",
+      false, "");
   cmd_parser.set_description(
       "Resamples complex samples from input rate to output rate. Input samples "
       "via stdin, output samples are written to stdout. By default the input "
@@ -59,6 +160,15 @@ int main(int argc, char **argv) {
   const double out_rate = cmd_parser.get<double>("output_rate");
   const double W = cmd_parser.get<double>("window_width");
 
+  // seed the process wide tap cache from disk before any Resample16 (or
+  // worker thread instance) is constructed
+  const std::string tap_dir = cmd_parser.get<std::string>("tap-cache");
+  if (!tap_dir.empty() &&
+      (cmd_parser.exist("int16") || cmd_parser.exist("taps")))
+    resample_taps_16_file(
+        myriota_rational_approximation(out_rate / in_rate, 1e-6, 1000, 10), W,
+        tap_dir.c_str());
+
   if (cmd_parser.exist("taps")) {
     Resample16shift r = Resample16shift(in_rate, out_rate, W);
     printf("alpha = %d\n", r.alpha);
@@ -70,15 +180,31 @@ int main(int argc, char **argv) {
     return EXIT_SUCCESS;
   }
 
+  const int threads = cmd_parser.get<int>("threads");
   if (cmd_parser.exist("int16") && cmd_parser.exist("shift")) {
-    Resample16shift r = Resample16shift(in_rate, out_rate, W);
-    resample<Resample16shift, myriota_complex_16>(stdin, r);
+    if (threads > 1) {
+      resample_threads<Resample16shift, myriota_complex_16>(
+          stdin, in_rate, out_rate, W, threads);
+    } else {
+      Resample16shift r = Resample16shift(in_rate, out_rate, W);
+      resample<Resample16shift, myriota_complex_16>(stdin, r);
+    }
   } else if (cmd_parser.exist("int16")) {
-    Resample16 r = Resample16(in_rate, out_rate, W);
-    resample<Resample16, myriota_complex_16>(stdin, r);
+    if (threads > 1) {
+      resample_threads<Resample16, myriota_complex_16>(stdin, in_rate, out_rate,
+                                                       W, threads);
+    } else {
+      Resample16 r = Resample16(in_rate, out_rate, W);
+      resample<Resample16, myriota_complex_16>(stdin, r);
+    }
   } else {  // double format by default
-    ResampleDouble r = ResampleDouble(in_rate, out_rate, W);
-    resample<ResampleDouble, complex>(stdin, r);
+    if (threads > 1) {
+      resample_threads<ResampleDouble, complex>(stdin, in_rate, out_rate, W,
+                                                threads);
+    } else {
+      ResampleDouble r = ResampleDouble(in_rate, out_rate, W);
+      resample<ResampleDouble, complex>(stdin, r);
+    }
   }
 
   return EXIT_SUCCESS;
@@ -0,0 +1,85 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tools/sample_pipe.h"
+#include <stdlib.h>
+#include "tools/cmdline.h"
+
+using namespace samplepipe;
+
+int main(int argc, char **argv) {
+  cmdline::parser cmd_parser;
+
+  cmd_parser.set_description(
+      "Runs a chain of sample processing stages in one process (see "
+      "tools/sample_pipe.h). Stages are given as arguments and run in order, "
+      "e.g.\n\n"
+      "    sample_pipe -f uint8 -t int16 'scale 128' 'resample 250000 5000'\n\n"
+      "replaces the equivalent convert_type | resample | convert_type shell "
+      "pipeline without the inter process copies and per hop format "
+      "conversions. Stages are:\n\n"
+      "    resample IN_RATE OUT_RATE [W]   rate change, identical output to "
+      "the resample tool\n"
+      "    cascade IN_RATE OUT_RATE [W]    multistage rate change, faster "
+      "for large ratios\n"
+      "    scale GAIN                      multiply by a real gain\n\n"
+      "Input samples via stdin, output samples are written to stdout.\n");
+  cmd_parser.add<std::string>("from", 'f',
+                              "input data type: double, float, uint8, "
+                              "int8, int16, uint16, int32 txt",
+                              false, "double");
+  cmd_parser.add<std::string>("to", 't',
+                              "output data type: double, float, uint8, "
+                              "int8, int16, uint16, int32 txt",
+                              false, "double");
+  cmd_parser.add("exit-on-clip", 'e',
+                 "program will exit with EXIT_FAILURE return code if any "
+                 "clipping detected");
+  cmd_parser.parse_check(argc, argv);
+
+  const ReadBlockFn read_block =
+      read_block_for(cmd_parser.get<std::string>("from"));
+  if (read_block == NULL) {
+    std::cerr << "Input type must be one of double, float, uint8, int8, int16, "
+                 "uint16, or int32"
+              << std::endl;
+    std::cerr << cmd_parser.usage();
+    return EXIT_FAILURE;
+  }
+  const PrintBlockFn print_block =
+      print_block_for(cmd_parser.get<std::string>("to"));
+  if (print_block == NULL) {
+    std::cerr
+        << "Output type must be one of double, float, int8, int16, uint16, or "
+           "int32"
+        << std::endl;
+    std::cerr << cmd_parser.usage();
+    return EXIT_FAILURE;
+  }
+
+  Pipeline pipeline;
+  if (!pipeline.build(cmd_parser.rest())) {
+    std::cerr << "invalid stage specification" << std::endl;
+    std::cerr << cmd_parser.usage();
+    return EXIT_FAILURE;
+  }
+
+  setvbuf(stdin, NULL, _IOFBF, 1 << 20);
+  setvbuf(stdout, NULL, _IOFBF, 1 << 20);
+  size_t nclipped = 0;
+  pipeline.run(stdin, stdout, read_block, print_block,
+               cmd_parser.exist("exit-on-clip"), nclipped);
+  if (cmd_parser.exist("exit-on-clip") && nclipped) return EXIT_FAILURE;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+// Copyright (c) 2016-2020, Myriota Pty Ltd, All Rights Reserved
+// SPDX-License-Identifier: BSD-3-Clause-Attribution
+//
+// This file is licensed under the BSD with attribution  (the "License"); you
+// may not use these files except in compliance with the License.
+//
+// You may obtain a copy of the License here:
+// LICENSE-BSD-3-Clause-Attribution.txt and at
+// https://spdx.org/licenses/BSD-3-Clause-Attribution.html
+//
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SAMPLE_PIPE_H
+#define SAMPLE_PIPE_H
+
+// In process pipeline of sample processing stages. The tools are designed to
+// be composed with shell pipes, e.g.
+//
+//   convert_type -f uint8 | resample -i 250000 -r 0.02 | convert_type -t int16
+//
+// but each hop costs a copy through the kernel pipe buffer and a decode and
+// re-encode of the interchange format. Here the same chain runs in one
+// process: stages pass blocks of complex samples between a pair of shared
+// buffers and the endpoint formats are converted once, at the edges, with the
+// block readers and writers of convert_type.h. A stage consumes all of its
+// input on every call, so no stage needs to buffer input between calls and
+// blocks flow through the chain without inter stage queues.
+
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+#include <vector>
+#include "math/myriotamath.h"
+#include "tools/convert_type.h"
+
+namespace samplepipe {
+
+// A pipeline stage. process consumes all of in[0..n) and appends any output
+// samples to out. A call with n = 0 flushes samples the stage still holds,
+// the runner makes one such call at end of stream.
+class Stage {
+ public:
+  virtual ~Stage() {}
+  virtual void process(const complex *in, size_t n,
+                       std::vector<complex> &out) = 0;
+};
+
+// rate change by a resampler class, ResampleDouble for output identical to
+// the resample tool or ResampleCascade for large rate ratios
+template <class R>
+class ResampleStage : public Stage {
+ public:
+  ResampleStage(const double in_rate, const double out_rate, const double W)
+      : r(in_rate, out_rate, W), tmp(1 << 14) {}
+  void process(const complex *in, size_t n,
+               std::vector<complex> &out) override {
+    size_t used = 0;
+    while (true) {
+      const uint64_t pushed = r.pushed();
+      const size_t nout = r.process(in + used, n - used, tmp.data(),
+                                    tmp.size());
+      used += r.pushed() - pushed;
+      out.insert(out.end(), tmp.begin(), tmp.begin() + nout);
+      if (used == n && nout < tmp.size()) return;
+    }
+  }
+
+ private:
+  R r;
+  std::vector<complex> tmp;
+};
+
+// multiplication by a real gain
+class ScaleStage : public Stage {
+ public:
+  ScaleStage(const double gain) : gain(gain) {}
+  void process(const complex *in, size_t n,
+               std::vector<complex> &out) override {
+    for (size_t i = 0; i < n; i++) out.push_back(gain * in[i]);
+  }
+
+ private:
+  const double gain;
+};
+
+// Build a stage from a specification string, NULL if it parses as none of:
+//
+//   "resample IN_RATE OUT_RATE [W]"   rate change, identical output to the
+//                                     resample tool, default W 30
+//   "cascade IN_RATE OUT_RATE [W]"    multistage rate change for large
+//                                     ratios, see ResampleCascade
+//   "scale GAIN"                      multiply by a real gain
+inline Stage *make_stage(const std::string &spec) {
+  char name[32];
+  double a = 0, b = 0, W = 30;
+  const int n =
+      sscanf(spec.c_str(), " %31s %lf %lf %lf", name, &a, &b, &W);
+  if (n >= 3 && strcmp(name, "resample") == 0)
+    return new ResampleStage<myriota::ResampleDouble>(a, b, W);
+  if (n >= 3 && strcmp(name, "cascade") == 0)
+    return new ResampleStage<myriota::ResampleCascade>(a, b, W);
+  if (n >= 2 && strcmp(name, "scale") == 0) return new ScaleStage(a);
+  return NULL;
+}
+
+// A chain of stages between typed endpoints. Blocks alternate between two
+// buffers as they move down the chain, the only per sample copies are the
+// stage outputs themselves.
+class Pipeline {
+ public:
+  // false if any specification is invalid, nothing runs in that case
+  bool build(const std::vector<std::string> &specs) {
+    for (size_t i = 0; i < specs.size(); i++) {
+      Stage *s = make_stage(specs[i]);
+      if (s == NULL) return false;
+      stages.push_back(std::shared_ptr<Stage>(s));
+    }
+    return true;
+  }
+
+  // Run infile through the chain to outfile, converting at the edges with
+  // the given block reader and writer. Accumulates clipped output components
+  // into nclipped and stops early once any clip when exit_on_clip is set.
+  void run(FILE *infile, FILE *outfile, ReadBlockFn read_block,
+           PrintBlockFn print_block, const bool exit_on_clip,
+           size_t &nclipped) {
+    std::vector<complex> in(1 << 16);
+    std::vector<complex> mid[2];
+    bool eof = false;
+    while (!eof) {
+      size_t n = read_block(infile, in.data(), in.size());
+      eof = n == 0;  // the final, empty, block flushes the stages
+      const complex *src = in.data();
+      for (size_t i = 0; i < stages.size(); i++) {
+        std::vector<complex> &dst = mid[i % 2];
+        dst.clear();
+        stages[i]->process(src, n, dst);
+        src = dst.data();
+        n = dst.size();
+      }
+      print_block(outfile, src, n, nclipped);
+      if (exit_on_clip && nclipped) return;
+    }
+  }
+
+  size_t size() const { return stages.size(); }
+
+ private:
+  std::vector<std::shared_ptr<Stage>> stages;
+};
+
+}  // namespace samplepipe
+
+#endif